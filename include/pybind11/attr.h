@@ -50,6 +50,14 @@ struct multiple_inheritance { };
 /// Annotation which enables dynamic attributes, i.e. adds `__dict__` to a class
 struct dynamic_attr { };
 
+/// Annotation which gives instances a fixed set of attributes (like `__slots__` in Python), which
+/// are stored inline rather than in a `__dict__`
+struct fixed_attrs {
+    std::vector<const char *> names;
+
+    template <typename... Names> explicit fixed_attrs(Names... names) : names{names...} { }
+};
+
 /// Annotation which enables the buffer protocol for a type
 struct buffer_protocol { };
 
@@ -67,6 +75,9 @@ struct metaclass {
 /// Annotation to mark enums as an arithmetic type
 struct arithmetic { };
 
+/// Annotation which makes a trivially copyable type picklable by copying its bytes
+struct pickle_trivial { };
+
 /** \rst
     A call policy which places one or more guard variables (``Ts...``) around the function call.
 
@@ -129,11 +140,15 @@ struct argument_record {
         : name(name), descr(descr), value(value), convert(convert), none(none) { }
 };
 
+/// Internal annotation which installs native slots on a newly created type (used by `enum_`)
+struct type_slots { void (*init)(PyHeapTypeObject *); };
+
 /// Internal data structure which holds metadata about a bound function (signature, overloads, etc.)
 struct function_record {
     function_record()
         : is_constructor(false), is_stateless(false), is_operator(false),
-          has_args(false), has_kwargs(false), is_method(false) { }
+          has_args(false), has_kwargs(false), is_method(false),
+          show_signature(true), show_doc(true) { }
 
     /// Function name
     char *name = nullptr; /* why no C++ strings? They generate heavier code.. */
@@ -141,12 +156,19 @@ struct function_record {
     // User-specified documentation string
     char *doc = nullptr;
 
-    /// Human-readable version of the function signature
+    /// Human-readable version of the function signature (generated on demand)
     char *signature = nullptr;
 
+    /// Compact description of the signature: text with type placeholders and the referenced types
+    const char *signature_text = nullptr;
+    const std::type_info *const *signature_types = nullptr;
+
     /// List of registered keyword arguments
     std::vector<argument_record> args;
 
+    /// Interned names of the keyword arguments and their positions in `args`, sorted by pointer
+    std::vector<std::pair<PyObject *, std::uint16_t>> keywords;
+
     /// Pointer to lambda function which converts arguments and performs the actual call
     handle (*impl) (function_call &) = nullptr;
 
@@ -177,6 +199,11 @@ struct function_record {
     /// True if this is a method
     bool is_method : 1;
 
+    /// Whether the docstring includes the signature and the user-defined docstring (the
+    /// `py::options` in effect when the function was registered)
+    bool show_signature : 1;
+    bool show_doc : 1;
+
     /// Number of arguments (including py::args and/or py::kwargs, if present)
     std::uint16_t nargs;
 
@@ -243,6 +270,12 @@ struct type_record {
     /// Is the default (unique_ptr) holder type used?
     bool default_holder : 1;
 
+    /// Names of attributes stored inline (`py::fixed_attrs`)
+    std::vector<const char *> fixed_attrs;
+
+    /// Installs custom slots on the type object before it is finalized (optional)
+    void (*init_slots)(PyHeapTypeObject *) = nullptr;
+
     PYBIND11_NOINLINE void add_base(const std::type_info &base, void *(*caster)(void *)) {
         auto base_info = detail::get_type_info(base, false);
         if (!base_info) {
@@ -398,6 +431,13 @@ struct process_attribute<dynamic_attr> : process_attribute_default<dynamic_attr>
     static void init(const dynamic_attr &, type_record *r) { r->dynamic_attr = true; }
 };
 
+template <>
+struct process_attribute<fixed_attrs> : process_attribute_default<fixed_attrs> {
+    static void init(const fixed_attrs &f, type_record *r) {
+        r->fixed_attrs.insert(r->fixed_attrs.end(), f.names.begin(), f.names.end());
+    }
+};
+
 template <>
 struct process_attribute<buffer_protocol> : process_attribute_default<buffer_protocol> {
     static void init(const buffer_protocol &, type_record *r) { r->buffer_protocol = true; }
@@ -409,10 +449,19 @@ struct process_attribute<metaclass> : process_attribute_default<metaclass> {
 };
 
 
+template <>
+struct process_attribute<type_slots> : process_attribute_default<type_slots> {
+    static void init(const type_slots &s, type_record *r) { r->init_slots = s.init; }
+};
+
 /// Process an 'arithmetic' attribute for enums (does nothing here)
 template <>
 struct process_attribute<arithmetic> : process_attribute_default<arithmetic> {};
 
+/// Process a 'pickle_trivial' attribute (handled by class_ itself)
+template <>
+struct process_attribute<pickle_trivial> : process_attribute_default<pickle_trivial> {};
+
 template <typename... Ts>
 struct process_attribute<call_guard<Ts...>> : process_attribute_default<call_guard<Ts...>> { };
 
@@ -88,6 +88,53 @@ private:
     bool ownview = false;
 };
 
+/** \rst
+    Fixed-capacity description of a buffer, filled in place by the ``class_::def_buffer`` callbacks
+    which take one as their second argument. Unlike returning a `buffer_info`, this does not
+    allocate anything on the heap when a buffer is exported. ``format`` must point to storage
+    which outlives the export, such as a string literal or ``format_descriptor<T>::value``.
+\endrst */
+struct buffer_record {
+    enum { max_ndim = 16 };
+
+    void *ptr = nullptr;            // Pointer to the underlying storage
+    ssize_t itemsize = 0;           // Size of individual items in bytes
+    const char *format = nullptr;   // Struct-module style format string of the items
+    ssize_t ndim = 0;               // Number of dimensions
+    ssize_t shape[max_ndim];        // Shape of the tensor (1 entry per dimension)
+    ssize_t strides[max_ndim];      // Number of bytes between adjacent entries (for each per dimension)
+    bool readonly = false;          // Whether consumers may only read the data
+
+    /// Describes an array of arithmetic values; C-contiguous strides are computed if none are
+    /// given. The data is marked as read-only if `T` is const.
+    template <typename T>
+    void set(T *data, std::initializer_list<ssize_t> shape_in,
+             std::initializer_list<ssize_t> strides_in = {}) {
+        using U = typename std::remove_const<T>::type;
+        if (shape_in.size() > max_ndim || (strides_in.size() && strides_in.size() != shape_in.size()))
+            pybind11_fail("buffer_record: ndim exceeds max_ndim or doesn't match strides length");
+        ptr = const_cast<U *>(data);
+        itemsize = (ssize_t) sizeof(U);
+        format = format_descriptor<U>::value;
+        ndim = (ssize_t) shape_in.size();
+        readonly = std::is_const<T>::value;
+        size_t i = 0;
+        for (auto s : shape_in)
+            shape[i++] = s;
+        if (strides_in.size()) {
+            i = 0;
+            for (auto s : strides_in)
+                strides[i++] = s;
+        } else {
+            ssize_t stride = itemsize;
+            for (ssize_t d = ndim - 1; d >= 0; --d) {
+                strides[d] = stride;
+                stride *= shape[d];
+            }
+        }
+    }
+};
+
 NAMESPACE_BEGIN(detail)
 
 template <typename T, typename SFINAE = void> struct compare_buffer_info {
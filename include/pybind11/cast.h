@@ -34,10 +34,17 @@ NAMESPACE_BEGIN(pybind11)
 NAMESPACE_BEGIN(detail)
 // Forward declarations:
 inline PyTypeObject *make_static_property_type();
+inline PyTypeObject *make_member_descriptor_type();
 inline PyTypeObject *make_default_metaclass();
 inline PyObject *make_object_base_type(PyTypeObject *metaclass);
 struct value_and_holder;
 
+/// An interned member of an `enum_` together with its precomputed repr()
+struct enum_member {
+    PyObject *value;
+    PyObject *repr;
+};
+
 /// Additional type information which does not fit into the PyTypeObject
 struct type_info {
     PyTypeObject *type;
@@ -50,7 +57,10 @@ struct type_info {
     std::vector<std::pair<const std::type_info *, void *(*)(void *)>> implicit_casts;
     std::vector<bool (*)(PyObject *, void *&)> *direct_conversions;
     buffer_info *(*get_buffer)(PyObject *, void *) = nullptr;
+    bool (*fill_buffer)(PyObject *, void *, buffer_record &) = nullptr;
     void *get_buffer_data = nullptr;
+    /* Members of an `enum_`, keyed by their underlying value (cast to unsigned long long) */
+    std::unordered_map<unsigned long long, enum_member> enum_members;
     /* A simple type never occurs as a (direct or indirect) parent
      * of a class that makes use of multiple inheritance */
     bool simple_type : 1;
@@ -67,24 +77,81 @@ struct type_info {
 template <int = PYBIND11_VERSION_MAJOR, int = PYBIND11_VERSION_MINOR>
 internals *&get_internals_ptr() { static internals *internals_ptr = nullptr; return internals_ptr; }
 
+inline PyThreadState *get_thread_state_unchecked() {
+#if defined(PYPY_VERSION)
+    return PyThreadState_GET();
+#elif PY_VERSION_HEX < 0x03000000
+    return _PyThreadState_Current;
+#elif PY_VERSION_HEX < 0x03050000
+    return (PyThreadState*) _Py_atomic_load_relaxed(&_PyThreadState_Current);
+#elif PY_VERSION_HEX < 0x03050200
+    return (PyThreadState*) _PyThreadState_Current.value;
+#else
+    return _PyThreadState_UncheckedGet();
+#endif
+}
+
+/// The internals last returned by `get_internals()` in this shared object, together with the
+/// interpreter they belong to.  Each (sub-)interpreter has its own internals, stored in a capsule
+/// in its builtins; the cache avoids the dictionary lookup while the same interpreter is active.
+struct internals_cache {
+    internals *ptr = nullptr;
+    PyInterpreterState *interp = nullptr;
+    interpreter_registry *registry = nullptr;
+    size_t generation = 0; // Value of `registry->generation` when `ptr` was looked up
+};
+
+template <int = PYBIND11_VERSION_MAJOR, int = PYBIND11_VERSION_MINOR>
+internals_cache &get_internals_cache() { static internals_cache cache; return cache; }
+
 PYBIND11_NOINLINE inline internals &get_internals() {
-    internals *&internals_ptr = get_internals_ptr();
-    if (internals_ptr)
-        return *internals_ptr;
+    auto &cache = get_internals_cache();
+    PyThreadState *current = get_thread_state_unchecked();
+    if (cache.ptr) {
+        // Comparing the interpreter is enough while no `subinterpreter` was destroyed since the
+        // lookup: only then can a new interpreter reuse the address of the cached one
+        bool valid = cache.generation == cache.registry->generation;
+        if (valid && (!current || current->interp == cache.interp))
+            return *cache.ptr;
+        // Without a thread state (e.g. in `gil_scoped_acquire`), only the thread state key is
+        // needed, which is shared by all interpreters
+        if (!current)
+            return valid ? *cache.ptr : *cache.registry->main;
+    }
     handle builtins(PyEval_GetBuiltins());
     const char *id = PYBIND11_INTERNALS_ID;
     if (builtins.contains(id) && isinstance<capsule>(builtins[id])) {
-        internals_ptr = *static_cast<internals **>(capsule(builtins[id]));
+        cache.ptr = *static_cast<internals **>(capsule(builtins[id]));
     } else {
+        // The internals of the first interpreter are referenced from `get_internals_ptr()` (which
+        // `finalize_interpreter()` relies on), those of sub-interpreters from a heap-allocated slot
+        internals **slot = &get_internals_ptr();
+        if (*slot)
+            slot = new internals *();
+        internals *&internals_ptr = *slot;
         internals_ptr = new internals();
+        // Set first, as creating the base types below already calls `get_internals()`
+        if (cache.registry) {
+            internals_ptr->interpreters = cache.registry;
+        } else {
+            internals_ptr->interpreters = new interpreter_registry();
+            internals_ptr->interpreters->main = internals_ptr;
+        }
         #if defined(WITH_THREAD)
             PyEval_InitThreads();
             PyThreadState *tstate = PyThreadState_Get();
-            internals_ptr->tstate = PyThread_create_key();
-            PyThread_set_key_value(internals_ptr->tstate, tstate);
+            if (cache.registry) {
+                // All interpreters share one key, so that a thread state created by
+                // `gil_scoped_acquire` or `subinterpreter_scoped_activate` is found regardless
+                // of the interpreter it belongs to
+                internals_ptr->tstate = cache.registry->main->tstate;
+            } else {
+                internals_ptr->tstate = PyThread_create_key();
+                PyThread_set_key_value(internals_ptr->tstate, tstate);
+            }
             internals_ptr->istate = tstate->interp;
         #endif
-        builtins[id] = capsule(&internals_ptr);
+        builtins[id] = capsule(slot);
         internals_ptr->registered_exception_translators.push_front(
             [](std::exception_ptr p) -> void {
                 try {
@@ -104,11 +171,17 @@ PYBIND11_NOINLINE inline internals &get_internals() {
                 }
             }
         );
+        ++internals_ptr->generic_exception_translator_count;
         internals_ptr->static_property_type = make_static_property_type();
+        internals_ptr->member_descriptor_type = make_member_descriptor_type();
         internals_ptr->default_metaclass = make_default_metaclass();
         internals_ptr->instance_base = make_object_base_type(internals_ptr->default_metaclass);
+        cache.ptr = internals_ptr;
     }
-    return *internals_ptr;
+    cache.registry = cache.ptr->interpreters;
+    cache.generation = cache.registry->generation;
+    cache.interp = current ? current->interp : nullptr;
+    return *cache.ptr;
 }
 
 /// A life support system for temporary objects created by `type_caster::load()`.
@@ -501,20 +574,6 @@ PYBIND11_NOINLINE inline handle get_object_handle(const void *ptr, const detail:
     return handle();
 }
 
-inline PyThreadState *get_thread_state_unchecked() {
-#if defined(PYPY_VERSION)
-    return PyThreadState_GET();
-#elif PY_VERSION_HEX < 0x03000000
-    return _PyThreadState_Current;
-#elif PY_VERSION_HEX < 0x03050000
-    return (PyThreadState*) _Py_atomic_load_relaxed(&_PyThreadState_Current);
-#elif PY_VERSION_HEX < 0x03050200
-    return (PyThreadState*) _PyThreadState_Current.value;
-#else
-    return _PyThreadState_UncheckedGet();
-#endif
-}
-
 // Forward declarations
 inline void keep_alive_impl(handle nurse, handle patient);
 inline void register_instance(instance *self, void *valptr, const type_info *tinfo);
@@ -777,13 +836,34 @@ public:
     static handle cast(const itype &src, return_value_policy policy, handle parent) {
         if (policy == return_value_policy::automatic || policy == return_value_policy::automatic_reference)
             policy = return_value_policy::copy;
+        if (policy == return_value_policy::copy || policy == return_value_policy::move) {
+            if (auto member = cast_enum_member(src))
+                return member;
+        }
         return cast(&src, policy, parent);
     }
 
     static handle cast(itype &&src, return_value_policy, handle parent) {
+        if (auto member = cast_enum_member(src))
+            return member;
         return cast(&src, return_value_policy::move, parent);
     }
 
+    // Enum values bound with `enum_` are returned as the interned member object (if there is one)
+    template <typename T = itype, enable_if_t<std::is_enum<T>::value, int> = 0>
+    static handle cast_enum_member(const itype &src) {
+        auto tinfo = get_type_info(typeid(itype));
+        if (tinfo && !tinfo->enum_members.empty()) {
+            auto it = tinfo->enum_members.find(static_cast<unsigned long long>(src));
+            if (it != tinfo->enum_members.end())
+                return handle(it->second.value).inc_ref();
+        }
+        return handle();
+    }
+
+    template <typename T = itype, enable_if_t<!std::is_enum<T>::value, int> = 0>
+    static handle cast_enum_member(const itype &) { return handle(); }
+
     // Returns a (pointer, type_info) pair taking care of necessary RTTI type lookup for a
     // polymorphic type.  If the instance isn't derived, returns the non-RTTI base version.
     template <typename T = itype, enable_if_t<std::is_polymorphic<T>::value, int> = 0>
@@ -1333,7 +1413,31 @@ struct holder_helper {
     static auto get(const T &p) -> decltype(p.get()) { return p.get(); }
 };
 
+/// Index of the entry of `tinfo->implicit_casts` through which an instance of `srctype` was last
+/// loaded (or `size_t(-1)`), so that loading holders of multiply-inherited classes tries it first.
+/// Loads of registered instances only depend on their Python type; if the hinted cast fails
+/// anyway (e.g. because a type object was replaced), all of the casts are tried.
+inline size_t &implicit_cast_hint(const type_info *tinfo, PyTypeObject *srctype, bool convert) {
+    using key = std::pair<const type_info *, PyTypeObject *>;
+    struct key_hash {
+        size_t operator()(const key &k) const {
+            return std::hash<const void *>()(k.first) ^ (std::hash<const void *>()(k.second) << 1);
+        }
+    };
+    // References to the elements stay valid when the table is rehashed
+    static std::unordered_map<key, std::array<size_t, 2>, key_hash> hints;
+    auto it = hints.find(key(tinfo, srctype));
+    if (it == hints.end())
+        it = hints.emplace(key(tinfo, srctype), std::array<size_t, 2>{{ size_t(-1), size_t(-1) }}).first;
+    return it->second[convert ? 1 : 0];
+}
+
 /// Type caster for holder types like std::shared_ptr, etc.
+///
+/// Loading doesn't copy the holder of the instance: functions taking a `const holder_type &`
+/// receive a reference to it, while parameters taken by value (or as non-const references or
+/// pointers) get a copy. Only loads through implicit casts (for multiple inheritance) need to
+/// construct an aliasing holder.
 template <typename type, typename holder_type>
 struct copyable_holder_caster : public type_caster_base<type> {
 public:
@@ -1349,16 +1453,29 @@ public:
         return base::template load_impl<copyable_holder_caster<type, holder_type>>(src, convert);
     }
 
+    template <typename T> using cast_op_type =
+        conditional_t<std::is_pointer<remove_reference_t<T>>::value,
+            conditional_t<std::is_const<typename std::remove_pointer<remove_reference_t<T>>::type>::value,
+                const holder_type *, holder_type *>,
+        conditional_t<std::is_rvalue_reference<T>::value, holder_type,
+        conditional_t<std::is_lvalue_reference<T>::value && !std::is_const<remove_reference_t<T>>::value,
+            holder_type &, const holder_type &>>>;
+
     explicit operator type*() { return this->value; }
     explicit operator type&() { return *(this->value); }
-    explicit operator holder_type*() { return &holder; }
+    explicit operator holder_type*() { return &own_holder(); }
+    explicit operator const holder_type*() { return instance_holder ? instance_holder : &holder; }
+    explicit operator const holder_type&() { return instance_holder ? *instance_holder : holder; }
+    explicit operator holder_type() && {
+        return instance_holder ? *instance_holder : std::move(holder);
+    }
 
     // Workaround for Intel compiler bug
     // see pybind11 issue 94
     #if defined(__ICC) || defined(__INTEL_COMPILER)
-    operator holder_type&() { return holder; }
+    operator holder_type&() { return own_holder(); }
     #else
-    explicit operator holder_type&() { return holder; }
+    explicit operator holder_type&() { return own_holder(); }
     #endif
 
     static handle cast(const holder_type &src, return_value_policy, handle) {
@@ -1373,10 +1490,19 @@ protected:
             throw cast_error("Unable to load a custom holder type from a default-holder instance");
     }
 
+    /// Returns a holder owned by the caster, which may be modified without affecting the instance
+    holder_type &own_holder() {
+        if (instance_holder) {
+            holder = *instance_holder;
+            instance_holder = nullptr;
+        }
+        return holder;
+    }
+
     bool load_value(const value_and_holder &v_h) {
         if (v_h.holder_constructed()) {
             value = v_h.value_ptr();
-            holder = v_h.holder<holder_type>();
+            instance_holder = &v_h.holder<holder_type>();
             return true;
         } else {
             throw cast_error("Unable to cast from non-held to held instance (T& to Holder<T>) "
@@ -1393,21 +1519,34 @@ protected:
 
     template <typename T = holder_type, detail::enable_if_t<std::is_constructible<T, const T &, type*>::value, int> = 0>
     bool try_implicit_casts(handle src, bool convert) {
-        for (auto &cast : typeinfo->implicit_casts) {
-            copyable_holder_caster sub_caster(*cast.first);
-            if (sub_caster.load(src, convert)) {
-                value = cast.second(sub_caster.value);
-                holder = holder_type(sub_caster.holder, (type *) value);
+        auto &casts = typeinfo->implicit_casts;
+        size_t &hint = implicit_cast_hint(typeinfo, Py_TYPE(src.ptr()), convert);
+        if (hint < casts.size() && try_implicit_cast(casts[hint], src, convert))
+            return true;
+        for (size_t i = 0; i < casts.size(); ++i) {
+            if (i != hint && try_implicit_cast(casts[i], src, convert)) {
+                hint = i;
                 return true;
             }
         }
         return false;
     }
 
+    template <typename Cast> bool try_implicit_cast(const Cast &cast, handle src, bool convert) {
+        copyable_holder_caster sub_caster(*cast.first);
+        if (!sub_caster.load(src, convert))
+            return false;
+        value = cast.second(sub_caster.value);
+        holder = holder_type(sub_caster.operator const holder_type &(), (type *) value);
+        instance_holder = nullptr;
+        return true;
+    }
+
     static bool try_direct_conversions(handle) { return false; }
 
 
     holder_type holder;
+    const holder_type *instance_holder = nullptr; // The loaded instance's holder, unless copied to `holder`
 };
 
 /// Specialize for the common std::shared_ptr, so users don't need to
@@ -1481,6 +1620,15 @@ struct pyobject_caster {
 template <typename T>
 class type_caster<T, enable_if_t<is_pyobject<T>::value>> : public pyobject_caster<T> { };
 
+/// Interned names are passed to Python as their (shared) string object; they cannot be loaded
+template <> class type_caster<interned> {
+public:
+    static handle cast(const interned &src, return_value_policy /* policy */, handle /* parent */) {
+        return src.ptr().inc_ref();
+    }
+    static PYBIND11_DESCR name() { return type_descr(_(PYBIND11_STRING_NAME)); }
+};
+
 // Our conditions for enabling moving are quite restrictive:
 // At compile time:
 // - T needs to be a non-const, non-pointer, non-reference type
@@ -1529,6 +1677,102 @@ template <typename Return, typename SFINAE = void> struct return_value_policy_ov
     }
 };
 
+NAMESPACE_END(detail)
+
+/** \rst
+    Describes a Python exception which a bound function raises through its return value (see
+    :class:`value_or_error`) rather than by throwing a C++ exception.  The exception is raised by
+    setting the Python error indicator directly, which avoids the cost of C++ stack unwinding and
+    exception translation.
+\endrst */
+struct error_result {
+    /// Raise an exception of Python type ``type``; the message is optional
+    error_result(handle type, std::string message = std::string())
+        : type(type), message(std::move(message)) { }
+
+    /// Set the Python error indicator
+    void restore() const {
+        if (message.empty())
+            PyErr_SetNone(type.ptr());
+        else
+            PyErr_SetString(type.ptr(), message.c_str());
+    }
+
+    handle type;
+    std::string message;
+};
+
+/** \rst
+    Return type for bound functions which produce either a ``T`` or an :class:`error_result`.  The
+    value is converted exactly as if ``T`` had been returned directly (including reference return
+    value policies); an error sets the Python error indicator and is returned to the caller
+    without throwing.
+
+    .. code-block:: cpp
+
+        .def("__getitem__", [](const Sequence &s, size_t i) -> py::value_or_error<float> {
+            if (i >= s.size())
+                return py::error_result(PyExc_IndexError);
+            return s[i];
+        })
+\endrst */
+template <typename T> class value_or_error {
+    using stored_type = detail::conditional_t<std::is_lvalue_reference<T>::value,
+        std::reference_wrapper<detail::remove_reference_t<T>>,
+        detail::remove_cv_t<detail::remove_reference_t<T>>>;
+public:
+    value_or_error(error_result error) : m_error(std::move(error)), m_has_value(false) { }
+
+    template <typename U, detail::enable_if_t<
+        std::is_convertible<U &&, T>::value &&
+        !std::is_same<typename std::decay<U>::type, error_result>::value, int> = 0>
+    value_or_error(U &&value) : m_error(handle()), m_has_value(true) {
+        new (&m_value) stored_type(std::forward<U>(value));
+    }
+
+    value_or_error(value_or_error &&other) : m_error(std::move(other.m_error)), m_has_value(other.m_has_value) {
+        if (m_has_value)
+            new (&m_value) stored_type(std::move(other.m_value));
+    }
+
+    ~value_or_error() { if (m_has_value) m_value.~stored_type(); }
+
+    /// True if a value (rather than an error) is held
+    explicit operator bool() const { return m_has_value; }
+
+    /// The held value; must only be called if `bool(*this)` is true
+    T value() && { return std::move(m_value); }
+
+    /// The held error; only meaningful if `bool(*this)` is false
+    const error_result &error() const { return m_error; }
+
+private:
+    error_result m_error;
+    bool m_has_value;
+    union { stored_type m_value; };
+};
+
+NAMESPACE_BEGIN(detail)
+
+// A `value_or_error<T>` is returned with the same policy as a plain `T`
+template <typename T> struct return_value_policy_override<value_or_error<T>>
+    : return_value_policy_override<T> { };
+
+template <typename T> class type_caster<value_or_error<T>> {
+    using caster_t = make_caster<T>;
+public:
+    static handle cast(value_or_error<T> &&src, return_value_policy policy, handle parent) {
+        if (!src) {
+            src.error().restore();
+            return handle();
+        }
+        return caster_t::cast(std::move(src).value(), policy, parent);
+    }
+    static PYBIND11_DESCR name() { return caster_t::name(); }
+};
+
+template <typename T> using is_value_or_error = is_instantiation<value_or_error, T>;
+
 // Basic python -> C++ casting; throws if casting fails
 template <typename T, typename SFINAE> type_caster<T, SFINAE> &load_type(type_caster<T, SFINAE> &conv, const handle &handle) {
     if (!conv.load(handle, true)) {
@@ -14,6 +14,8 @@
 #include <cmath>
 #include <ctime>
 #include <chrono>
+#include <limits>
+#include <ratio>
 #include <datetime.h>
 
 // Backport the PyDateTime_DELTA functions from Python3.3 if required
@@ -28,8 +30,70 @@
 #endif
 
 NAMESPACE_BEGIN(pybind11)
+
+/** \rst
+    A ``std::chrono::system_clock`` time point that converts to and from naive ``datetime.datetime``
+    objects expressed in UTC rather than in local time. The conversion is pure calendar arithmetic:
+    unlike the plain ``time_point`` caster, it never calls ``std::mktime``/``std::localtime``, which
+    consult the time zone database and serialize on a global lock. Time zone aware datetimes are
+    converted to UTC when loading.
+\endrst */
+template <typename Duration = std::chrono::system_clock::duration>
+class utc_time_point : public std::chrono::time_point<std::chrono::system_clock, Duration> {
+public:
+    using base = std::chrono::time_point<std::chrono::system_clock, Duration>;
+    utc_time_point() = default;
+    utc_time_point(const base &t) : base(t) { }
+    explicit utc_time_point(const Duration &d) : base(d) { }
+};
+
 NAMESPACE_BEGIN(detail)
 
+/// Returns true if `duration_cast<To>(d)` neither overflows its intermediate product nor the
+/// representation of `To` (nanosecond counts only span about +/- 292 years)
+template <typename To, typename Rep, typename Period>
+bool duration_fits(const std::chrono::duration<Rep, Period> &d) {
+    using ratio = std::ratio_divide<Period, typename To::period>;
+    using to_limits = std::numeric_limits<typename To::rep>;
+    if (std::is_floating_point<Rep>::value) {
+        // Also rejects NaN, which compares false against both bounds
+        long double count = (long double) d.count() * ratio::num / ratio::den;
+        return count >= (long double) to_limits::lowest() && count < (long double) to_limits::max();
+    }
+    using common = typename std::common_type<Rep, typename To::rep, std::intmax_t>::type;
+    using common_limits = std::numeric_limits<common>;
+    common count = (common) d.count();
+    if (count > common_limits::max() / ratio::num ||
+        (std::is_signed<common>::value && count < common_limits::lowest() / ratio::num))
+        return false;
+    count = count * ratio::num / ratio::den;
+    return count <= (common) to_limits::max() &&
+           (std::is_unsigned<common>::value || count >= (common) to_limits::lowest());
+}
+
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar, and its inverse; see
+// http://howardhinnant.github.io/date_algorithms.html
+inline int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned) (y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t) doe - 719468;
+}
+
+inline void civil_from_days(int64_t z, int &y, int &m, int &d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned) (z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = (int) (doy - (153 * mp + 2) / 5 + 1);
+    m = (int) (mp < 10 ? mp + 3 : mp - 9);
+    y = (int) (era * 400 + yoe + (m <= 2));
+}
+
 template <typename type> class duration_caster {
 public:
     typedef typename type::rep rep;
@@ -147,6 +211,69 @@ public:
     PYBIND11_TYPE_CASTER(type, _("datetime.datetime"));
 };
 
+template <typename Duration> class type_caster<utc_time_point<Duration>> {
+public:
+    typedef utc_time_point<Duration> type;
+    bool load(handle src, bool) {
+        using namespace std::chrono;
+
+        // Lazy initialise the PyDateTime import
+        if (!PyDateTimeAPI) { PyDateTime_IMPORT; }
+
+        if (!src || !PyDateTime_Check(src.ptr()))
+            return false;
+
+        int64_t days = days_from_civil(PyDateTime_GET_YEAR(src.ptr()),
+                                       (unsigned) PyDateTime_GET_MONTH(src.ptr()),
+                                       (unsigned) PyDateTime_GET_DAY(src.ptr()));
+        int64_t secs = days * 86400
+                     + PyDateTime_DATE_GET_HOUR(src.ptr()) * 3600
+                     + PyDateTime_DATE_GET_MINUTE(src.ptr()) * 60
+                     + PyDateTime_DATE_GET_SECOND(src.ptr());
+        microseconds us(secs * 1000000 + PyDateTime_DATE_GET_MICROSECOND(src.ptr()));
+
+        if (((PyDateTime_DateTime *) src.ptr())->hastzinfo) {
+            auto offset = src.attr("utcoffset")();
+            if (!offset.is_none()) {
+                if (!PyDelta_Check(offset.ptr()))
+                    return false;
+                us -= microseconds((PyDateTime_DELTA_GET_DAYS(offset.ptr()) * (int64_t) 86400
+                                    + PyDateTime_DELTA_GET_SECONDS(offset.ptr())) * 1000000
+                                   + PyDateTime_DELTA_GET_MICROSECONDS(offset.ptr()));
+            }
+        }
+
+        // With nanosecond counts, only about 1678-2262 is representable
+        if (!duration_fits<Duration>(us))
+            return false;
+        value = type(duration_cast<Duration>(us));
+        return true;
+    }
+
+    static handle cast(const type &src, return_value_policy /* policy */, handle /* parent */) {
+        using namespace std::chrono;
+
+        // Lazy initialise the PyDateTime import
+        if (!PyDateTimeAPI) { PyDateTime_IMPORT; }
+
+        // Round towards negative infinity, so that times before the epoch work too
+        auto us = duration_cast<microseconds>(src.time_since_epoch());
+        if (us > src.time_since_epoch())
+            us -= microseconds(1);
+
+        const int64_t us_per_day = 86400 * (int64_t) 1000000;
+        int64_t days = us.count() / us_per_day, rem = us.count() % us_per_day;
+        if (rem < 0) { days -= 1; rem += us_per_day; }
+
+        int year, month, day;
+        civil_from_days(days, year, month, day);
+        int secs = (int) (rem / 1000000);
+        return PyDateTime_FromDateAndTime(year, month, day, secs / 3600, secs / 60 % 60, secs % 60,
+                                          (int) (rem % 1000000));
+    }
+    PYBIND11_TYPE_CASTER(type, _("datetime.datetime"));
+};
+
 // Other clocks that are not the system clock are not measured as datetime.datetime objects
 // since they are not measured on calendar time. So instead we just make them timedeltas
 // Or if they have passed us a time as a float we convert that
@@ -0,0 +1,121 @@
+/*
+    pybind11/chrono_numpy.h: Bulk conversion between vectors of std::chrono time points and
+    durations and NumPy datetime64[ns] / timedelta64[ns] arrays
+
+    Copyright (c) 2017 Wenzel Jakob <wenzel.jakob@epfl.ch>
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "chrono.h"
+#include "numpy.h"
+#include "stl.h"
+
+NAMESPACE_BEGIN(pybind11)
+NAMESPACE_BEGIN(detail)
+
+static_assert(sizeof(std::chrono::nanoseconds::rep) == 8,
+              "NumPy datetime64/timedelta64 support requires 64-bit nanosecond counts");
+
+// NumPy counts datetime64 values from the Unix epoch, which is also the epoch of system_clock on
+// all supported platforms (and is guaranteed by C++20)
+using datetime64_ns = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+using timedelta64_ns = std::chrono::nanoseconds;
+
+template <> struct npy_format_descriptor<datetime64_ns> {
+    static PYBIND11_DESCR name() { return _("datetime64[ns]"); }
+    static pybind11::dtype dtype() { return pybind11::dtype("M8[ns]"); }
+};
+
+template <> struct npy_format_descriptor<timedelta64_ns> {
+    static PYBIND11_DESCR name() { return _("timedelta64[ns]"); }
+    static pybind11::dtype dtype() { return pybind11::dtype("m8[ns]"); }
+};
+
+template <typename Rep, typename Period>
+timedelta64_ns to_numpy_chrono(const std::chrono::duration<Rep, Period> &d) {
+    if (!duration_fits<timedelta64_ns>(d))
+        throw value_error("duration is out of range for timedelta64[ns]");
+    return std::chrono::duration_cast<timedelta64_ns>(d);
+}
+template <typename Duration>
+datetime64_ns to_numpy_chrono(const std::chrono::time_point<std::chrono::system_clock, Duration> &t) {
+    if (!duration_fits<timedelta64_ns>(t.time_since_epoch()))
+        throw value_error("time point is out of range for datetime64[ns]");
+    return std::chrono::time_point_cast<timedelta64_ns>(t);
+}
+
+template <typename Rep, typename Period>
+void from_numpy_chrono(timedelta64_ns src, std::chrono::duration<Rep, Period> &dst) {
+    using To = std::chrono::duration<Rep, Period>;
+    if (!duration_fits<To>(src))
+        throw value_error("timedelta64[ns] value is out of range for the target duration");
+    dst = std::chrono::duration_cast<To>(src);
+}
+template <typename Duration>
+void from_numpy_chrono(datetime64_ns src, std::chrono::time_point<std::chrono::system_clock, Duration> &dst) {
+    if (!duration_fits<Duration>(src.time_since_epoch()))
+        throw value_error("datetime64[ns] value is out of range for the target time point");
+    dst = std::chrono::time_point_cast<Duration>(src);
+}
+
+/* Converts vectors of time points or durations to and from one-dimensional datetime64[ns] or
+   timedelta64[ns] arrays, moving the int64 counts in bulk rather than creating a datetime or
+   timedelta object per element. Arrays of other datetime64/timedelta64 units or with a
+   non-contiguous layout are converted by NumPy first, but only when conversions are allowed; any
+   other sequence falls back to the element-wise list conversion. Values which do not fit the
+   target representation raise ValueError. */
+template <typename Type, typename Value, typename NumpyValue, char Kind> struct chrono_array_caster {
+    bool load(handle src, bool convert) {
+        if (!isinstance<array>(src) || reinterpret_borrow<array>(src).dtype().kind() != Kind) {
+            list_caster<Type, Value> fallback;
+            if (!fallback.load(src, convert))
+                return false;
+            value = std::move(static_cast<Type &>(fallback));
+            return true;
+        }
+
+        if (!convert && (!array_t<NumpyValue>::check_(src) ||
+                         !check_flags(src.ptr(), npy_api::NPY_ARRAY_C_CONTIGUOUS_)))
+            return false;
+
+        auto arr = array_t<NumpyValue, array::c_style | array::forcecast>::ensure(src);
+        if (!arr || arr.ndim() != 1)
+            return false;
+
+        const NumpyValue *data = arr.data();
+        size_t size = (size_t) arr.size();
+        value.clear();
+        value.resize(size);
+        for (size_t i = 0; i < size; ++i)
+            from_numpy_chrono(data[i], value[i]);
+        return true;
+    }
+
+    template <typename T>
+    static handle cast(T &&src, return_value_policy /* policy */, handle /* parent */) {
+        array_t<NumpyValue> result(src.size());
+        NumpyValue *data = result.mutable_data();
+        for (size_t i = 0; i < src.size(); ++i)
+            data[i] = to_numpy_chrono(src[i]);
+        return result.release();
+    }
+
+    PYBIND11_TYPE_CASTER(Type, _("numpy.ndarray[") + npy_format_descriptor<NumpyValue>::name() + _("]"));
+};
+
+template <typename Duration, typename Alloc>
+struct type_caster<std::vector<std::chrono::time_point<std::chrono::system_clock, Duration>, Alloc>>
+    : chrono_array_caster<std::vector<std::chrono::time_point<std::chrono::system_clock, Duration>, Alloc>,
+                          std::chrono::time_point<std::chrono::system_clock, Duration>, datetime64_ns, 'M'> { };
+
+template <typename Rep, typename Period, typename Alloc>
+struct type_caster<std::vector<std::chrono::duration<Rep, Period>, Alloc>>
+    : chrono_array_caster<std::vector<std::chrono::duration<Rep, Period>, Alloc>,
+                          std::chrono::duration<Rep, Period>, timedelta64_ns, 'm'> { };
+
+NAMESPACE_END(detail)
+NAMESPACE_END(pybind11)
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "attr.h"
+#include <structmember.h>
 
 NAMESPACE_BEGIN(pybind11)
 NAMESPACE_BEGIN(detail)
@@ -87,6 +88,213 @@ inline PyTypeObject *make_static_property_type() {
 
 #endif // PYPY
 
+/// Data of a `pybind11_member` descriptor, which `def_readwrite` and `def_readonly` install for
+/// fields of arithmetic, `bool` and registered POD type in place of a `property` (see
+/// `class_::def_member`). Fields are accessed at a byte offset from the instance's value pointer
+/// and converted directly, bypassing the function dispatcher.
+struct member_record {
+    char *name = nullptr;
+    char *doc = nullptr;
+    const type_info *tinfo = nullptr; // The class the field belongs to
+
+    /// Byte offset of the field from a `tinfo` value pointer (including any base class adjustment);
+    /// resolved by `resolve` on first access
+    ssize_t offset = -1;
+    ssize_t (*resolve)(void *value, const member_record &rec) = nullptr;
+
+    /// Return a new reference to the field value, or nullptr with an error set
+    PyObject *(*get)(void *field, PyObject *self) = nullptr;
+
+    /// Assign the field from `value`, or return false with an error set; nullptr for read-only fields
+    bool (*set)(void *field, PyObject *value) = nullptr;
+
+    /// Storage for the member pointer
+    void *data[2] = { nullptr, nullptr };
+
+    ~member_record() { std::free(name); std::free(doc); }
+};
+
+struct member_descriptor {
+    PyObject_HEAD
+    member_record *rec;
+};
+
+#if !defined(PYPY_VERSION)
+
+/// Find the value pointer of the `rec.tinfo` part of `obj`, handling the common cases of
+/// `type_caster_generic::load_impl` inline.
+inline void *member_value_ptr(PyObject *obj, const member_record &rec) {
+    const type_info *tinfo = rec.tinfo;
+    PyTypeObject *type = Py_TYPE(obj);
+    void *value = nullptr;
+    if (type == tinfo->type) {
+        value = reinterpret_cast<instance *>(obj)->get_value_and_holder().value_ptr();
+    } else if (PyType_IsSubtype(type, tinfo->type)) {
+        auto &bases = all_type_info(type);
+        if (bases.size() == 1 && (tinfo->simple_type || bases.front()->type == tinfo->type)) {
+            value = reinterpret_cast<instance *>(obj)->get_value_and_holder().value_ptr();
+        } else {
+            // C++ multiple inheritance is involved; let the generic caster find the right base
+            struct loader : type_caster_generic {
+                using type_caster_generic::type_caster_generic;
+                using type_caster_generic::value;
+            } caster(*tinfo->cpptype);
+            if (caster.load(obj, false))
+                value = caster.value;
+        }
+    }
+    if (!value)
+        PyErr_Format(PyExc_TypeError, "descriptor '%s' for '%s' objects doesn't apply to a '%s' object",
+                     rec.name, tinfo->type->tp_name, type->tp_name);
+    return value;
+}
+
+inline void *member_field_ptr(PyObject *obj, member_record &rec) {
+    void *value = member_value_ptr(obj, rec);
+    if (!value)
+        return nullptr;
+    if (rec.offset < 0)
+        rec.offset = rec.resolve(value, rec);
+    return static_cast<char *>(value) + rec.offset;
+}
+
+/// `pybind11_member.__get__()`: Accessed through the class, return the descriptor itself.
+extern "C" inline PyObject *pybind11_member_get(PyObject *self, PyObject *obj, PyObject * /*type*/) {
+    if (!obj || obj == Py_None) {
+        Py_INCREF(self);
+        return self;
+    }
+    auto &rec = *reinterpret_cast<member_descriptor *>(self)->rec;
+    void *field = member_field_ptr(obj, rec);
+    return field ? rec.get(field, obj) : nullptr;
+}
+
+/// `pybind11_member.__set__()`
+extern "C" inline int pybind11_member_set(PyObject *self, PyObject *obj, PyObject *value) {
+    auto &rec = *reinterpret_cast<member_descriptor *>(self)->rec;
+    if (!value || !rec.set) {
+        PyErr_SetString(PyExc_AttributeError, value ? "can't set attribute" : "can't delete attribute");
+        return -1;
+    }
+    void *field = member_field_ptr(obj, rec);
+    return field && rec.set(field, value) ? 0 : -1;
+}
+
+extern "C" inline PyObject *pybind11_member_get_doc(PyObject *self, void *) {
+    auto &rec = *reinterpret_cast<member_descriptor *>(self)->rec;
+    if (!rec.doc)
+        return handle(Py_None).inc_ref().ptr();
+    return PYBIND11_FROM_STRING(rec.doc);
+}
+
+extern "C" inline PyObject *pybind11_member_get_name(PyObject *self, void *) {
+    return PYBIND11_FROM_STRING(reinterpret_cast<member_descriptor *>(self)->rec->name);
+}
+
+extern "C" inline void pybind11_member_dealloc(PyObject *self) {
+    delete reinterpret_cast<member_descriptor *>(self)->rec;
+    Py_TYPE(self)->tp_free(self);
+}
+
+/** Create the type of the descriptors installed by `def_readwrite` and `def_readonly` for
+    fields which can be accessed natively.
+    Return value: New reference. */
+inline PyTypeObject *make_member_descriptor_type() {
+    constexpr auto *name = "pybind11_member";
+    auto name_obj = reinterpret_steal<object>(PYBIND11_FROM_STRING(name));
+
+    /* Danger zone: from now (and until PyType_Ready), make sure to
+       issue no Python C API calls which could potentially invoke the
+       garbage collector (the GC will call type_traverse(), which will in
+       turn find the newly constructed type in an invalid state) */
+    auto heap_type = (PyHeapTypeObject *) PyType_Type.tp_alloc(&PyType_Type, 0);
+    if (!heap_type)
+        pybind11_fail("make_member_descriptor_type(): error allocating type!");
+
+    heap_type->ht_name = name_obj.inc_ref().ptr();
+#if PY_MAJOR_VERSION >= 3 && PY_MINOR_VERSION >= 3
+    heap_type->ht_qualname = name_obj.inc_ref().ptr();
+#endif
+
+    auto type = &heap_type->ht_type;
+    type->tp_name = name;
+    type->tp_base = &PyBaseObject_Type;
+    type->tp_basicsize = static_cast<ssize_t>(sizeof(member_descriptor));
+    type->tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE;
+    type->tp_dealloc = pybind11_member_dealloc;
+    type->tp_descr_get = pybind11_member_get;
+    type->tp_descr_set = pybind11_member_set;
+
+    static PyGetSetDef getset[] = {
+        {const_cast<char*>("__doc__"), pybind11_member_get_doc, nullptr, nullptr, nullptr},
+        {const_cast<char*>("__name__"), pybind11_member_get_name, nullptr, nullptr, nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+    type->tp_getset = getset;
+
+    if (PyType_Ready(type) < 0)
+        pybind11_fail("make_member_descriptor_type(): failure in PyType_Ready()!");
+
+    setattr((PyObject *) type, "__module__", str("pybind11_builtins"));
+
+    return type;
+}
+
+/** Create the type of the function objects created by `cpp_function`: a builtin function whose
+    ``__doc__`` is produced by `get_doc`, which lets the docstring be generated on first access.
+    Return value: New reference. */
+inline PyTypeObject *make_function_type(getter get_doc) {
+    constexpr auto *name = "pybind11_builtin_function";
+    auto name_obj = reinterpret_steal<object>(PYBIND11_FROM_STRING(name));
+
+    /* Danger zone: from now (and until PyType_Ready), make sure to
+       issue no Python C API calls which could potentially invoke the
+       garbage collector (the GC will call type_traverse(), which will in
+       turn find the newly constructed type in an invalid state) */
+    auto heap_type = (PyHeapTypeObject *) PyType_Type.tp_alloc(&PyType_Type, 0);
+    if (!heap_type)
+        pybind11_fail("make_function_type(): error allocating type!");
+
+    heap_type->ht_name = name_obj.inc_ref().ptr();
+#if PY_MAJOR_VERSION >= 3 && PY_MINOR_VERSION >= 3
+    heap_type->ht_qualname = name_obj.inc_ref().ptr();
+#endif
+
+    auto type = &heap_type->ht_type;
+    type->tp_name = name;
+    type->tp_base = &PyCFunction_Type;
+    type->tp_basicsize = PyCFunction_Type.tp_basicsize;
+    type->tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE;
+
+    static PyGetSetDef getset[] = {
+        {const_cast<char*>("__doc__"), get_doc, nullptr, nullptr, nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+    type->tp_getset = getset;
+
+    // Gives the type a `__module__` entry which still resolves to the module of each function
+    static PyMemberDef members[] = {
+        {const_cast<char*>("__module__"), T_OBJECT, offsetof(PyCFunctionObject, m_module), PY_WRITE_RESTRICTED, nullptr},
+        {nullptr, 0, 0, 0, nullptr}
+    };
+    type->tp_members = members;
+
+    if (PyType_Ready(type) < 0)
+        pybind11_fail("make_function_type(): failure in PyType_Ready()!");
+
+    return type;
+}
+
+#else // PYPY
+
+/// Fields are always bound as properties on PyPy
+inline PyTypeObject *make_member_descriptor_type() { return nullptr; }
+
+/// Docstrings are always generated eagerly on PyPy
+inline PyTypeObject *make_function_type(getter) { return nullptr; }
+
+#endif // PYPY
+
 /** Types with static properties need to handle `Type.static_prop = x` in a specific way.
     By default, Python replaces the `static_property` itself, but for wrapped C++ types
     we need to call `static_property.__set__()` in order to propagate the new value to
@@ -232,6 +440,9 @@ inline bool deregister_instance(instance *self, void *valptr, const type_info *t
 /// call the constructor -- an `__init__` function must do that.  If allocating value, the instance
 /// is registered; otherwise register_instance will need to be called once the value has been
 /// assigned.
+extern "C" inline int pybind11_traverse(PyObject *self, visitproc visit, void *arg);
+extern "C" inline void pybind11_object_dealloc(PyObject *self);
+
 inline PyObject *make_new_instance(PyTypeObject *type, bool allocate_value /*= true (in cast.h)*/) {
 #if defined(PYPY_VERSION)
     // PyPy gets tp_basicsize wrong (issue 2482) under multiple inheritance when the first inherited
@@ -246,6 +457,12 @@ inline PyObject *make_new_instance(PyTypeObject *type, bool allocate_value /*= t
     // Allocate the value/holder internals:
     inst->allocate_layout();
 
+    // Instances with dynamic or fixed attributes can only be part of reference cycles once they
+    // store an attribute, so the garbage collector only tracks them from then on. (Instances of
+    // Python subclasses are always tracked, since they may reference objects in other ways.)
+    if (type->tp_traverse == pybind11_traverse)
+        PyObject_GC_UnTrack(self);
+
     inst->owned = true;
     // Allocate (if requested) the value pointers; otherwise leave them as nullptr
     if (allocate_value) {
@@ -303,6 +520,36 @@ inline void clear_patients(PyObject *self) {
         Py_CLEAR(patient);
 }
 
+/// The inline storage of the `py::fixed_attrs` of an instance (including those of its bases), which
+/// lies between the `instance` struct and the `__dict__` pointer (if any)
+struct fixed_attr_range {
+    PyObject **first, **last;
+    PyObject **begin() const { return first; }
+    PyObject **end() const { return last; }
+};
+
+inline fixed_attr_range fixed_attr_slots(PyObject *self) {
+    // Python subclasses may add their own storage after ours, so find the first pybind11 type
+    auto type = Py_TYPE(self);
+    while (type->tp_dealloc != pybind11_object_dealloc && type->tp_base)
+        type = type->tp_base;
+    auto first = reinterpret_cast<char *>(self) + sizeof(instance);
+    auto last = reinterpret_cast<char *>(self) + (type->tp_dictoffset > 0 ? type->tp_dictoffset : type->tp_basicsize);
+    if (last < first)
+        last = first;
+    return {reinterpret_cast<PyObject **>(first), reinterpret_cast<PyObject **>(last)};
+}
+
+/// Starts tracking an instance with dynamic or fixed attributes in the garbage collector
+inline void track_instance(PyObject *self) {
+#if PY_VERSION_HEX >= 0x03090000
+    if (!PyObject_GC_IsTracked(self))
+#else
+    if (!_PyObject_GC_IS_TRACKED(self))
+#endif
+        PyObject_GC_Track(self);
+}
+
 /// Clears all internal data from the instance and removes it from registered instances in
 /// preparation for deallocation.
 inline void clear_instance(PyObject *self) {
@@ -328,6 +575,9 @@ inline void clear_instance(PyObject *self) {
     if (dict_ptr)
         Py_CLEAR(*dict_ptr);
 
+    for (auto &attr : fixed_attr_slots(self))
+        Py_CLEAR(attr);
+
     if (instance->has_patients)
         clear_patients(self);
 }
@@ -384,8 +634,11 @@ inline PyObject *make_object_base_type(PyTypeObject *metaclass) {
 /// dynamic_attr: Support for `d = instance.__dict__`.
 extern "C" inline PyObject *pybind11_get_dict(PyObject *self, void *) {
     PyObject *&dict = *_PyObject_GetDictPtr(self);
-    if (!dict)
+    if (!dict) {
         dict = PyDict_New();
+        if (dict)
+            track_instance(self);
+    }
     Py_XINCREF(dict);
     return dict;
 }
@@ -401,23 +654,124 @@ extern "C" inline int pybind11_set_dict(PyObject *self, PyObject *new_dict, void
     Py_INCREF(new_dict);
     Py_CLEAR(dict);
     dict = new_dict;
+    track_instance(self);
+    return 0;
+}
+
+/// dynamic_attr: Storing an attribute in the instance `__dict__` starts tracking the instance in
+/// the garbage collector (see `make_new_instance`).
+extern "C" inline int pybind11_setattro(PyObject *self, PyObject *name, PyObject *value) {
+    if (PyObject_GenericSetAttr(self, name, value) != 0)
+        return -1;
+    PyObject **dict = _PyObject_GetDictPtr(self);
+    if (value && dict && *dict)
+        track_instance(self);
+    return 0;
+}
+
+/// fixed_attrs: The name and instance offset of a fixed attribute slot
+struct fixed_attr {
+    const char *name;
+    ssize_t offset;
+};
+
+inline PyObject *&fixed_attr_slot(PyObject *self, void *closure) {
+    return *reinterpret_cast<PyObject **>(reinterpret_cast<char *>(self) +
+                                          static_cast<fixed_attr *>(closure)->offset);
+}
+
+/// fixed_attrs: Support for `instance.attr`.
+extern "C" inline PyObject *pybind11_get_fixed_attr(PyObject *self, void *closure) {
+    PyObject *value = fixed_attr_slot(self, closure);
+    if (!value) {
+        PyErr_Format(PyExc_AttributeError, "'%.200s' object has no attribute '%s'",
+                     Py_TYPE(self)->tp_name, static_cast<fixed_attr *>(closure)->name);
+        return nullptr;
+    }
+    Py_INCREF(value);
+    return value;
+}
+
+/// fixed_attrs: Support for `instance.attr = value` and `del instance.attr`. Storing a value
+/// starts tracking the instance in the garbage collector (see `make_new_instance`); this also
+/// covers stores which bypass `tp_setattro`, such as `type(instance).attr.__set__(instance, value)`.
+extern "C" inline int pybind11_set_fixed_attr(PyObject *self, PyObject *value, void *closure) {
+    PyObject *&slot = fixed_attr_slot(self, closure);
+    if (!value && !slot) {
+        PyErr_Format(PyExc_AttributeError, "'%.200s' object has no attribute '%s'",
+                     Py_TYPE(self)->tp_name, static_cast<fixed_attr *>(closure)->name);
+        return -1;
+    }
+    PyObject *old = slot;
+    Py_XINCREF(value);
+    slot = value;
+    Py_XDECREF(old);
+    if (value)
+        track_instance(self);
     return 0;
 }
 
-/// dynamic_attr: Allow the garbage collector to traverse the internal instance `__dict__`.
+/// dynamic_attr, fixed_attrs: Allow the garbage collector to traverse the internal instance
+/// `__dict__` and fixed attributes.
 extern "C" inline int pybind11_traverse(PyObject *self, visitproc visit, void *arg) {
-    PyObject *&dict = *_PyObject_GetDictPtr(self);
-    Py_VISIT(dict);
+    PyObject **dict = _PyObject_GetDictPtr(self);
+    if (dict)
+        Py_VISIT(*dict);
+    for (auto attr : fixed_attr_slots(self))
+        Py_VISIT(attr);
     return 0;
 }
 
-/// dynamic_attr: Allow the GC to clear the dictionary.
+/// dynamic_attr, fixed_attrs: Allow the GC to clear the dictionary and fixed attributes.
 extern "C" inline int pybind11_clear(PyObject *self) {
-    PyObject *&dict = *_PyObject_GetDictPtr(self);
-    Py_CLEAR(dict);
+    PyObject **dict = _PyObject_GetDictPtr(self);
+    if (dict)
+        Py_CLEAR(*dict);
+    for (auto &attr : fixed_attr_slots(self))
+        Py_CLEAR(attr);
     return 0;
 }
 
+/// Opt into garbage collection for types whose instances store Python objects. Instances are only
+/// tracked once they actually store one (see `make_new_instance`).
+inline void enable_instance_gc(PyTypeObject *type) {
+    type->tp_flags |= Py_TPFLAGS_HAVE_GC;
+    type->tp_traverse = pybind11_traverse;
+    type->tp_clear = pybind11_clear;
+    type->tp_setattro = pybind11_setattro;
+}
+
+/// Store the attributes named by `py::fixed_attrs` inline at the end of the instances, exposed
+/// through getset descriptors (like `__slots__`). The `__dict__` descriptor of `py::dynamic_attr`
+/// shares the same `tp_getset` table, so it is added here when both are requested.
+inline void enable_fixed_attributes(PyHeapTypeObject *heap_type, const std::vector<const char *> &names,
+                                    bool dynamic_attr) {
+    auto type = &heap_type->ht_type;
+#if defined(PYPY_VERSION)
+    pybind11_fail(std::string(type->tp_name) + ": fixed attributes are "
+                                               "currently not supported in "
+                                               "conjunction with PyPy!");
+#endif
+    auto attrs = new fixed_attr[names.size()];
+    auto getset = new PyGetSetDef[names.size() + 2]();
+    for (size_t i = 0; i < names.size(); ++i) {
+        attrs[i].name = strdup(names[i]);
+        attrs[i].offset = type->tp_basicsize;
+        type->tp_basicsize += (ssize_t) sizeof(PyObject *);
+        getset[i].name = const_cast<char *>(attrs[i].name);
+        getset[i].get = pybind11_get_fixed_attr;
+        getset[i].set = pybind11_set_fixed_attr;
+        getset[i].closure = &attrs[i];
+    }
+    if (dynamic_attr) {
+        getset[names.size()].name = const_cast<char *>("__dict__");
+        getset[names.size()].get = pybind11_get_dict;
+        getset[names.size()].set = pybind11_set_dict;
+    }
+    type->tp_getset = getset;
+    enable_instance_gc(type);
+}
+
 /// Give instances of this type a `__dict__` and opt into garbage collection.
 inline void enable_dynamic_attributes(PyHeapTypeObject *heap_type) {
     auto type = &heap_type->ht_type;
@@ -426,58 +780,152 @@ inline void enable_dynamic_attributes(PyHeapTypeObject *heap_type) {
                                                "currently not supported in "
                                                "conjunction with PyPy!");
 #endif
-    type->tp_flags |= Py_TPFLAGS_HAVE_GC;
     type->tp_dictoffset = type->tp_basicsize; // place dict at the end
     type->tp_basicsize += (ssize_t)sizeof(PyObject *); // and allocate enough space for it
-    type->tp_traverse = pybind11_traverse;
-    type->tp_clear = pybind11_clear;
+    enable_instance_gc(type);
 
     static PyGetSetDef getset[] = {
         {const_cast<char*>("__dict__"), pybind11_get_dict, pybind11_set_dict, nullptr, nullptr},
         {nullptr, nullptr, nullptr, nullptr, nullptr}
     };
-    type->tp_getset = getset;
+    if (!type->tp_getset) // Otherwise already provided by `enable_fixed_attributes`
+        type->tp_getset = getset;
 }
 
-/// buffer_protocol: Fill in the view as specified by flags.
-extern "C" inline int pybind11_getbuffer(PyObject *obj, Py_buffer *view, int flags) {
-    // Look for a `get_buffer` implementation in this type's info or any bases (following MRO).
-    type_info *tinfo = nullptr;
-    for (auto type : reinterpret_borrow<tuple>(Py_TYPE(obj)->tp_mro)) {
-        tinfo = get_type_info((PyTypeObject *) type.ptr());
-        if (tinfo && tinfo->get_buffer)
+/// buffer_protocol: Per-export state referenced by `Py_buffer::internal`. Released records are
+/// kept on a free list and reused, so exports described by a `buffer_record` don't allocate.
+struct buffer_export {
+    buffer_record record;
+    buffer_info *info = nullptr; // Set when the `def_buffer` callback returned a `buffer_info`
+};
+
+inline std::vector<buffer_export *> &buffer_export_free_list() {
+    static std::vector<buffer_export *> free_list;
+    return free_list;
+}
+
+inline void release_buffer_export(buffer_export *exp) {
+    delete exp->info;
+    exp->info = nullptr;
+    buffer_export_free_list().push_back(exp);
+}
+
+/// buffer_protocol: Find the `type_info` providing the buffer of instances of `type` (i.e. the
+/// first type in its MRO with a `def_buffer` implementation). The result is cached per type.
+inline type_info *get_buffer_type_info(PyTypeObject *type) {
+    auto &cache = get_internals().buffer_types;
+    auto it = cache.find(type);
+    if (it != cache.end())
+        return it->second;
+
+    type_info *result = nullptr;
+    for (auto base : reinterpret_borrow<tuple>(type->tp_mro)) {
+        type_info *tinfo = get_type_info((PyTypeObject *) base.ptr());
+        if (tinfo && (tinfo->get_buffer || tinfo->fill_buffer)) {
+            result = tinfo;
             break;
+        }
     }
-    if (view == nullptr || obj == nullptr || !tinfo || !tinfo->get_buffer) {
+    cache.emplace(type, result);
+    return result;
+}
+
+/// buffer_protocol: Fill in the view as specified by flags.
+extern "C" inline int pybind11_getbuffer(PyObject *obj, Py_buffer *view, int flags) {
+    type_info *tinfo = obj ? get_buffer_type_info(Py_TYPE(obj)) : nullptr;
+    if (view == nullptr || obj == nullptr || !tinfo) {
         if (view)
             view->obj = nullptr;
         PyErr_SetString(PyExc_BufferError, "pybind11_getbuffer(): Internal error");
         return -1;
     }
+
+    auto &free_list = buffer_export_free_list();
+    buffer_export *exp;
+    if (free_list.empty()) {
+        exp = new buffer_export();
+    } else {
+        exp = free_list.back();
+        free_list.pop_back();
+    }
+
+    buffer_record &rec = exp->record;
+    const char *format;
+    const ssize_t *shape, *strides;
+    if (tinfo->fill_buffer) {
+        rec = buffer_record();
+        bool ok = tinfo->fill_buffer(obj, tinfo->get_buffer_data, rec);
+        if (!ok || rec.ndim < 0 || rec.ndim > buffer_record::max_ndim) {
+            release_buffer_export(exp);
+            view->obj = nullptr;
+            if (!PyErr_Occurred())
+                PyErr_SetString(PyExc_BufferError, "pybind11_getbuffer(): Internal error");
+            return -1;
+        }
+        format = rec.format ? rec.format : "B";
+        shape = rec.shape;
+        strides = rec.strides;
+    } else {
+        buffer_info *info = tinfo->get_buffer(obj, tinfo->get_buffer_data);
+        if (!info) {
+            release_buffer_export(exp);
+            view->obj = nullptr;
+            PyErr_SetString(PyExc_BufferError, "pybind11_getbuffer(): Internal error");
+            return -1;
+        }
+        exp->info = info;
+        rec.ptr = info->ptr;
+        rec.itemsize = info->itemsize;
+        rec.ndim = info->ndim;
+        rec.readonly = false;
+        format = info->format.c_str();
+        shape = info->shape.data();
+        strides = info->strides.data();
+    }
+
+    // Without strides, consumers assume the data to be C-contiguous
+    bool c_contiguous = true;
+    ssize_t len = rec.itemsize;
+    for (ssize_t i = rec.ndim - 1; i >= 0; --i) {
+        if (shape[i] != 1 && strides[i] != len)
+            c_contiguous = false;
+        len *= shape[i];
+    }
+    const char *error = nullptr;
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && rec.readonly)
+        error = "Writable buffer requested for readonly storage";
+    else if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !c_contiguous)
+        error = "Buffer is not C-contiguous, but strides were not requested";
+    if (error) {
+        release_buffer_export(exp);
+        view->obj = nullptr;
+        PyErr_SetString(PyExc_BufferError, error);
+        return -1;
+    }
+
     std::memset(view, 0, sizeof(Py_buffer));
-    buffer_info *info = tinfo->get_buffer(obj, tinfo->get_buffer_data);
     view->obj = obj;
+    view->internal = exp;
+    view->buf = rec.ptr;
+    view->itemsize = rec.itemsize;
+    view->len = len;
+    view->readonly = rec.readonly;
     view->ndim = 1;
-    view->internal = info;
-    view->buf = info->ptr;
-    view->itemsize = info->itemsize;
-    view->len = view->itemsize;
-    for (auto s : info->shape)
-        view->len *= s;
     if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT)
-        view->format = const_cast<char *>(info->format.c_str());
-    if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) {
-        view->ndim = (int) info->ndim;
-        view->strides = &info->strides[0];
-        view->shape = &info->shape[0];
+        view->format = const_cast<char *>(format);
+    if ((flags & PyBUF_ND) == PyBUF_ND) {
+        view->ndim = (int) rec.ndim;
+        view->shape = const_cast<ssize_t *>(shape);
     }
+    if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)
+        view->strides = const_cast<ssize_t *>(strides);
     Py_INCREF(view->obj);
     return 0;
 }
 
 /// buffer_protocol: Release the resources of the buffer.
 extern "C" inline void pybind11_releasebuffer(PyObject *, Py_buffer *view) {
-    delete (buffer_info *) view->internal;
+    release_buffer_export((buffer_export *) view->internal);
 }
 
 /// Give this type a buffer interface.
@@ -554,6 +1002,17 @@ inline PyObject* make_new_python_type(const type_record &rec) {
     type->tp_doc = tp_doc;
     type->tp_base = (PyTypeObject *) handle(base).inc_ref().ptr();
     type->tp_basicsize = static_cast<ssize_t>(sizeof(instance));
+    // Keep the fixed attributes of a base (which precede its `__dict__`)
+    for (auto b : bases) {
+        auto base_type = (PyTypeObject *) b.ptr();
+        auto size = base_type->tp_dictoffset > 0 ? base_type->tp_dictoffset : base_type->tp_basicsize;
+        if (size <= static_cast<ssize_t>(sizeof(instance)))
+            continue;
+        if (type->tp_basicsize > static_cast<ssize_t>(sizeof(instance)))
+            pybind11_fail(std::string(rec.name) + ": can't inherit fixed attributes from multiple bases!");
+        type->tp_basicsize = size;
+    }
+    bool has_fixed_attrs = type->tp_basicsize > static_cast<ssize_t>(sizeof(instance));
     if (bases.size() > 0)
         type->tp_bases = bases.release().ptr();
 
@@ -571,17 +1030,26 @@ inline PyObject* make_new_python_type(const type_record &rec) {
     type->tp_flags |= Py_TPFLAGS_CHECKTYPES;
 #endif
 
+    if (!rec.fixed_attrs.empty())
+        enable_fixed_attributes(heap_type, rec.fixed_attrs, rec.dynamic_attr);
+    else if (has_fixed_attrs)
+        enable_instance_gc(type);
+
     if (rec.dynamic_attr)
         enable_dynamic_attributes(heap_type);
 
     if (rec.buffer_protocol)
         enable_buffer_protocol(heap_type);
 
+    if (rec.init_slots)
+        rec.init_slots(heap_type);
+
     if (PyType_Ready(type) < 0)
         pybind11_fail(std::string(rec.name) + ": PyType_Ready failed (" + error_string() + ")!");
 
-    assert(rec.dynamic_attr ? PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC)
-                            : !PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC));
+    assert(rec.dynamic_attr || has_fixed_attrs || !rec.fixed_attrs.empty()
+               ? PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC)
+               : !PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC));
 
     /* Register type with the parent scope */
     if (rec.scope)
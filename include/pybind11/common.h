@@ -187,10 +187,15 @@ extern "C" {
 #endif
 
 #define PYBIND11_TRY_NEXT_OVERLOAD ((PyObject *) 1) // special failure return code
+#define PYBIND11_ERROR_RESULT ((PyObject *) 2) // special return code: Python error indicator already set
 #define PYBIND11_STRINGIFY(x) #x
 #define PYBIND11_TOSTRING(x) PYBIND11_STRINGIFY(x)
+/// Incremented whenever the layout of `internals` or of the structures it refers to changes, so that
+/// modules built against different layouts never share (and misread) the same internals
+#define PYBIND11_INTERNALS_VERSION 1
 #define PYBIND11_INTERNALS_ID "__pybind11_" \
-    PYBIND11_TOSTRING(PYBIND11_VERSION_MAJOR) "_" PYBIND11_TOSTRING(PYBIND11_VERSION_MINOR) "__"
+    PYBIND11_TOSTRING(PYBIND11_VERSION_MAJOR) "_" PYBIND11_TOSTRING(PYBIND11_VERSION_MINOR) \
+    "_internals_v" PYBIND11_TOSTRING(PYBIND11_INTERNALS_VERSION) "__"
 
 /** \rst
     ***Deprecated in favor of PYBIND11_MODULE***
@@ -224,7 +229,10 @@ extern "C" {
             return nullptr;                                                    \
         }                                                                      \
         try {                                                                  \
-            return pybind11_init();                                            \
+            if (auto m = pybind11::detail::get_initialized_module(#name))      \
+                return m;                                                      \
+            auto m = pybind11_init();                                          \
+            return pybind11::detail::add_initialized_module(#name, m);         \
         } catch (pybind11::error_already_set &e) {                             \
             e.clear();                                                         \
             PyErr_SetString(PyExc_ImportError, e.what());                      \
@@ -268,10 +276,12 @@ extern "C" {
                          major, minor);                                        \
             return nullptr;                                                    \
         }                                                                      \
-        auto m = pybind11::module(#name);                                      \
         try {                                                                  \
+            if (auto m = pybind11::detail::get_initialized_module(#name))      \
+                return m;                                                      \
+            auto m = pybind11::module(#name);                                  \
             pybind11_init_##name(m);                                           \
-            return m.ptr();                                                    \
+            return pybind11::detail::add_initialized_module(#name, m.ptr());   \
         } catch (pybind11::error_already_set &e) {                             \
             e.clear();                                                         \
             PyErr_SetString(PyExc_ImportError, e.what());                      \
@@ -427,6 +437,20 @@ struct overload_hash {
     }
 };
 
+/// Hashes the contents of a NUL-terminated string (used to look up interned names)
+struct c_str_hash {
+    size_t operator()(const char *s) const {
+        size_t value = 0;
+        while (*s)
+            value = value * 31 + (unsigned char) *s++;
+        return value;
+    }
+};
+
+struct c_str_equal {
+    bool operator()(const char *a, const char *b) const { return std::strcmp(a, b) == 0; }
+};
+
 // Python loads modules by default with dlopen with the RTLD_LOCAL flag; under libc++ and possibly
 // other stls, this means `typeid(A)` from one module won't equal `typeid(A)` from another module
 // even when `A` is the same, non-hidden-visibility type (e.g. from a common include).  Under
@@ -462,20 +486,45 @@ struct type_equal_to {
 template <typename value_type>
 using type_map = std::unordered_map<std::type_index, value_type, type_hash, type_equal_to>;
 
+/// An exception translator registered for a specific C++ exception type (see `register_exception`)
+struct typed_exception_translator {
+    void (*translator)(std::exception_ptr);
+    size_t generic_before; // Number of generic translators that were registered before this one
+};
+
+struct internals;
+
+/// Shared by the internals of all interpreters of the process. `generation` advances whenever a
+/// `subinterpreter` is destroyed, which invalidates the internals cached by every module.
+struct interpreter_registry {
+    size_t generation = 0;
+    internals *main = nullptr; // Internals of the interpreter which created the registry
+};
+
 /// Internal data structure used to track registered instances and types
 struct internals {
     type_map<void *> registered_types_cpp; // std::type_index -> type_info
     std::unordered_map<PyTypeObject *, std::vector<type_info *>> registered_types_py; // PyTypeObject* -> base type_info(s)
+    std::unordered_map<PyTypeObject *, type_info *> buffer_types; // PyTypeObject* -> type_info providing its buffer (or nullptr)
     std::unordered_multimap<const void *, instance*> registered_instances; // void * -> instance*
     std::unordered_set<std::pair<const PyObject *, const char *>, overload_hash> inactive_overload_cache;
     type_map<std::vector<bool (*)(PyObject *, void *&)>> direct_conversions;
     std::unordered_map<const PyObject *, std::vector<PyObject *>> patients;
     std::forward_list<void (*) (std::exception_ptr)> registered_exception_translators;
+    size_t generic_exception_translator_count = 0; // Length of `registered_exception_translators`
+    std::vector<typed_exception_translator> registered_typed_exception_translators; // In order of registration
+    type_map<size_t> typed_exception_translator_cache; // Thrown type -> index of the typed translator handling it (or -1 if none)
+    type_map<void *> registered_exceptions; // C++ exception type -> `exception<T>` created by `register_exception`
     std::unordered_map<std::string, void *> shared_data; // Custom data to be shared across extensions
     std::vector<PyObject *> loader_patient_stack; // Used by `loader_life_support`
+    std::unordered_map<std::string, PyObject *> initialized_modules; // Module name -> module created in this interpreter
+    std::unordered_map<const char *, PyObject *, c_str_hash, c_str_equal> interned_names; // See `interned`; keys point into the values
     PyTypeObject *static_property_type;
+    PyTypeObject *member_descriptor_type; // nullptr on PyPy
+    PyTypeObject *function_type = nullptr; // Created by the first `cpp_function`; stays nullptr on PyPy
     PyTypeObject *default_metaclass;
     PyObject *instance_base;
+    interpreter_registry *interpreters = nullptr;
 #if defined(WITH_THREAD)
     decltype(PyThread_create_key()) tstate = 0; // Usually an int but a long on Cygwin64 with Python 3.x
     PyInterpreterState *istate = nullptr;
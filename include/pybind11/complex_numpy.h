@@ -0,0 +1,65 @@
+/*
+    pybind11/complex_numpy.h: Bulk conversion between vectors of std::complex values and
+    NumPy complex64 / complex128 arrays
+
+    Copyright (c) 2017 Wenzel Jakob <wenzel.jakob@epfl.ch>
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "complex.h"
+#include "numpy.h"
+#include "stl.h"
+#include <cstring>
+
+NAMESPACE_BEGIN(pybind11)
+NAMESPACE_BEGIN(detail)
+
+/* Converts vectors of complex numbers to and from one-dimensional complex NumPy arrays, copying
+   the (real, imag) pairs in bulk rather than creating a Python complex object per element.
+   Complex arrays of another precision or with a non-contiguous layout are converted by NumPy
+   first, but only when conversions are allowed; any other sequence falls back to the element-wise
+   list conversion. */
+template <typename Type, typename Value> struct complex_array_caster {
+    bool load(handle src, bool convert) {
+        if (!isinstance<array>(src) || reinterpret_borrow<array>(src).dtype().kind() != 'c') {
+            list_caster<Type, Value> fallback;
+            if (!fallback.load(src, convert))
+                return false;
+            value = std::move(static_cast<Type &>(fallback));
+            return true;
+        }
+
+        if (!convert && (!array_t<Value>::check_(src) ||
+                         !check_flags(src.ptr(), npy_api::NPY_ARRAY_C_CONTIGUOUS_)))
+            return false;
+
+        auto arr = array_t<Value, array::c_style | array::forcecast>::ensure(src);
+        if (!arr || arr.ndim() != 1)
+            return false;
+
+        const Value *data = arr.data();
+        value.assign(data, data + arr.size());
+        return true;
+    }
+
+    template <typename T>
+    static handle cast(T &&src, return_value_policy /* policy */, handle /* parent */) {
+        array_t<Value> result(src.size());
+        if (!src.empty())
+            std::memcpy(result.mutable_data(), src.data(), src.size() * sizeof(Value));
+        return result.release();
+    }
+
+    PYBIND11_TYPE_CASTER(Type, _("numpy.ndarray[") + npy_format_descriptor<Value>::name() + _("]"));
+};
+
+template <typename T, typename Alloc>
+struct type_caster<std::vector<std::complex<T>, Alloc>>
+    : complex_array_caster<std::vector<std::complex<T>, Alloc>, std::complex<T>> { };
+
+NAMESPACE_END(detail)
+NAMESPACE_END(pybind11)
@@ -11,6 +11,13 @@
 
 #include "pybind11.h"
 #include "eval.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #if defined(PYPY_VERSION)
 #  error Embedding the interpreter is not supported with PyPy
@@ -46,10 +53,12 @@
 #define PYBIND11_EMBEDDED_MODULE(name, variable)                              \
     static void pybind11_init_##name(pybind11::module &);                     \
     static PyObject *pybind11_init_wrapper_##name() {                         \
-        auto m = pybind11::module(#name);                                     \
         try {                                                                 \
+            if (auto m = pybind11::detail::get_initialized_module(#name))     \
+                return m;                                                     \
+            auto m = pybind11::module(#name);                                 \
             pybind11_init_##name(m);                                          \
-            return m.ptr();                                                   \
+            return pybind11::detail::add_initialized_module(#name, m.ptr());  \
         } catch (pybind11::error_already_set &e) {                            \
             e.clear();                                                        \
             PyErr_SetString(PyExc_ImportError, e.what());                     \
@@ -153,10 +162,14 @@ inline void finalize_interpreter() {
 
     Py_Finalize();
 
-    if (internals_ptr_ptr) {
+    if (internals_ptr_ptr && *internals_ptr_ptr) {
+        auto registry = (*internals_ptr_ptr)->interpreters;
+        if (registry && registry->main == *internals_ptr_ptr)
+            delete registry;
         delete *internals_ptr_ptr;
         *internals_ptr_ptr = nullptr;
     }
+    detail::get_internals_cache() = detail::internals_cache();
 }
 
 /** \rst
@@ -192,4 +205,302 @@ private:
     bool is_valid = true;
 };
 
+#if PY_MAJOR_VERSION >= 3
+/** \rst
+    Scope guard which creates a sub-interpreter of the running (embedded) interpreter and
+    destroys it again, including its copies of all modules, when it goes out of scope. Extension
+    modules are initialized separately for every interpreter which imports them and each
+    interpreter has its own ``internals`` (type registry, instance map, exception translators,
+    etc.), so types and objects never leak from one interpreter to another.
+
+    Both the constructor and the destructor must be called with the GIL held; they leave the
+    calling thread's current thread state unchanged. Code is run inside the sub-interpreter via
+    `subinterpreter_scoped_activate`. All sub-interpreters must be destroyed before
+    `finalize_interpreter()` is called.
+
+    .. code-block:: cpp
+
+        py::scoped_interpreter guard{};
+        py::subinterpreter sub;
+        {
+            py::subinterpreter_scoped_activate activate(sub);
+            py::exec("import example");  // independent of any `example` in the main interpreter
+        }
+
+    .. note::
+
+        All interpreters of CPython versions up to 3.11 share a single GIL, so threads
+        running different sub-interpreters are isolated but do not run Python code in parallel.
+
+ \endrst */
+class subinterpreter {
+public:
+    subinterpreter() {
+        key = detail::get_internals().tstate;
+        PyThreadState *previous = PyThreadState_Get();
+        tstate = Py_NewInterpreter();
+        if (!tstate) {
+            PyThreadState_Swap(previous);
+            pybind11_fail("subinterpreter: could not create a new interpreter!");
+        }
+        // Create the internals (and with them the pybind11 base types) of the new interpreter
+        // right away, while its initial thread state is current
+        detail::get_internals();
+        PyThreadState_Swap(previous);
+    }
+
+    subinterpreter(const subinterpreter &) = delete;
+    subinterpreter(subinterpreter &&other) noexcept : tstate(other.tstate), key(other.key) { other.tstate = nullptr; }
+    subinterpreter &operator=(const subinterpreter &) = delete;
+    subinterpreter &operator=(subinterpreter &&) = delete;
+
+    ~subinterpreter() {
+        if (!tstate)
+            return;
+        PyThreadState *previous = PyThreadState_Swap(tstate);
+        // Refreshes the cache while the builtins (which reference the internals) are still intact
+        auto &internals = detail::get_internals();
+        auto slot = static_cast<detail::internals **>(
+            capsule(handle(PyEval_GetBuiltins())[PYBIND11_INTERNALS_ID]));
+        Py_EndInterpreter(tstate);
+        PyThreadState_Swap(previous);
+
+        // Modules still caching the internals look them up again before their next use
+        ++internals.interpreters->generation;
+        delete slot;
+        delete &internals;
+    }
+
+    /// The CPython state of the sub-interpreter
+    PyInterpreterState *state() const { return tstate ? tstate->interp : nullptr; }
+
+private:
+    friend class subinterpreter_scoped_activate;
+
+    PyThreadState *tstate = nullptr; // Initial thread state, used to destroy the interpreter
+    decltype(detail::internals::tstate) key = 0; // Thread state key shared by all interpreters
+};
+
+/** \rst
+    Scope guard which makes a sub-interpreter the active interpreter of the calling thread: a new
+    thread state of the sub-interpreter is created, the GIL is acquired on its behalf and
+    `gil_scoped_acquire`/`gil_scoped_release` use it until the guard goes out of scope. Any
+    thread may activate any sub-interpreter. If the calling thread holds the GIL through another
+    thread state, it is released for the lifetime of the guard and reacquired afterwards.
+ \endrst */
+class subinterpreter_scoped_activate {
+public:
+    explicit subinterpreter_scoped_activate(const subinterpreter &interp) : key(interp.key) {
+        if (!interp.state())
+            pybind11_fail("subinterpreter_scoped_activate: invalid sub-interpreter!");
+        previous_key_value = PyThread_get_key_value(key);
+        PyThreadState *current = detail::get_thread_state_unchecked();
+        if (current && (current == previous_key_value || current == PyGILState_GetThisThreadState()))
+            previous = PyEval_SaveThread();
+
+        // Like any thread state not created by `gil_scoped_acquire`, it starts out with a GIL state
+        // count of one, so that nested `gil_scoped_acquire` guards leave it alive
+        tstate = PyThreadState_New(interp.state());
+        if (!tstate)
+            pybind11_fail("subinterpreter_scoped_activate: could not create thread state!");
+        PyThread_set_key_value(key, tstate);
+        PyEval_RestoreThread(tstate);
+    }
+
+    subinterpreter_scoped_activate(const subinterpreter_scoped_activate &) = delete;
+    subinterpreter_scoped_activate &operator=(const subinterpreter_scoped_activate &) = delete;
+
+    ~subinterpreter_scoped_activate() {
+        PyThreadState_Clear(tstate);
+        PyThreadState_DeleteCurrent();
+        PyThread_set_key_value(key, previous_key_value);
+        if (previous)
+            PyEval_RestoreThread(previous);
+    }
+
+private:
+    decltype(detail::internals::tstate) key;
+    void *previous_key_value = nullptr;
+    PyThreadState *previous = nullptr;
+    PyThreadState *tstate = nullptr;
+};
+#endif
+
+#if defined(WITH_THREAD)
+/** \rst
+    A pool of threads which run jobs submitted from any C++ thread with the GIL held. Every worker
+    creates its thread state once and takes as many queued jobs as possible (up to ``batch_size``)
+    per acquisition of the GIL, instead of each caller creating or looking up a thread state and
+    competing for the GIL on its own.
+
+    .. code-block:: cpp
+
+        py::scoped_interpreter guard{};
+        py::interpreter_executor executor(2);
+        py::gil_scoped_release release;
+
+        // From any thread:
+        std::future<int> answer = executor.submit([]() {
+            return py::module::import("math").attr("gcd")(84, 126).cast<int>();
+        });
+
+    Exceptions thrown by a job are rethrown by ``std::future::get()``. Jobs should not return
+    Python objects: their destructors would run on the waiting thread, which need not hold the
+    GIL. Waiting on a future while holding the GIL deadlocks if the job has not started yet. The
+    executor must be created with the GIL held. The destructor runs all jobs submitted so far and
+    then stops the workers; the interpreter must still be running at that point.
+ \endrst */
+class interpreter_executor {
+public:
+    /// Queue and latency statistics, collected since the construction of the executor
+    struct statistics {
+        size_t submitted = 0;       // Jobs submitted
+        size_t completed = 0;       // Jobs which ran (including those which threw)
+        size_t batches = 0;         // Acquisitions of the GIL which ran at least one job
+        size_t queue_depth = 0;     // Jobs currently waiting
+        size_t max_queue_depth = 0; // Largest number of jobs waiting at the same time
+        std::chrono::nanoseconds total_wait{0}; // Summed time between submission and start of a job
+        std::chrono::nanoseconds max_wait{0};   // Longest time between submission and start of a job
+    };
+
+    explicit interpreter_executor(size_t num_threads = 1, size_t batch_size = 64)
+        : max_batch(batch_size ? batch_size : 1) {
+        if (num_threads == 0)
+            pybind11_fail("interpreter_executor: at least one worker thread is required");
+        // Created here (with the GIL held) rather than by the first worker acquiring the GIL
+        detail::get_internals();
+        workers.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i)
+            workers.emplace_back([this]() { run(); });
+    }
+
+    interpreter_executor(const interpreter_executor &) = delete;
+    interpreter_executor &operator=(const interpreter_executor &) = delete;
+
+    ~interpreter_executor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+#if PY_VERSION_HEX >= 0x03040000
+        bool holds_gil = PyGILState_Check() != 0;
+#else
+        auto tstate = detail::get_thread_state_unchecked();
+        bool holds_gil = tstate && tstate == PyGILState_GetThisThreadState();
+#endif
+        // The workers need the GIL to finish the remaining jobs
+        if (holds_gil) {
+            gil_scoped_release release;
+            join();
+        } else {
+            join();
+        }
+    }
+
+    /// Queue a callable taking no arguments; its result (or exception) is delivered via the future
+    template <typename Func, typename Return = decltype(std::declval<Func &>()())>
+    std::future<Return> submit(Func &&func) {
+        auto task = std::make_shared<std::packaged_task<Return()>>(
+            counted_job<typename std::decay<Func>::type>{this, std::forward<Func>(func)});
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping)
+                pybind11_fail("interpreter_executor: cannot submit jobs to a stopped executor");
+            queue.push_back(job{[task]() { (*task)(); }, clock::now()});
+            ++counters.submitted;
+            if (queue.size() > counters.max_queue_depth)
+                counters.max_queue_depth = queue.size();
+        }
+        ready.notify_one();
+        return result;
+    }
+
+    size_t num_threads() const { return workers.size(); }
+
+    /// Snapshot of the statistics
+    statistics stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        statistics result = counters;
+        result.queue_depth = queue.size();
+        return result;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct job {
+        std::function<void()> func;
+        clock::time_point submitted;
+    };
+
+    /// Counts a job as completed when it returns or throws, i.e. before `packaged_task` makes its
+    /// result available: whoever waits on the future already sees it in `stats()`
+    template <typename Func> struct counted_job {
+        interpreter_executor *executor;
+        Func func;
+
+        struct completion {
+            interpreter_executor *executor;
+            ~completion() {
+                // Never held while waiting for the GIL, so this cannot deadlock
+                std::lock_guard<std::mutex> lock(executor->mutex);
+                ++executor->counters.completed;
+            }
+        };
+
+        auto operator()() -> decltype(std::declval<Func &>()()) {
+            completion done{executor};
+            return func();
+        }
+    };
+
+    void run() {
+        gil_scoped_acquire gil;
+        std::vector<job> batch;
+        batch.reserve(max_batch);
+        while (true) {
+            {
+                gil_scoped_release release;
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+
+                auto now = clock::now();
+                while (!queue.empty() && batch.size() < max_batch) {
+                    auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        now - queue.front().submitted);
+                    counters.total_wait += wait;
+                    if (wait > counters.max_wait)
+                        counters.max_wait = wait;
+                    batch.push_back(std::move(queue.front()));
+                    queue.pop_front();
+                }
+                ++counters.batches;
+            }
+
+            // `packaged_task` stores any exception in the future
+            for (auto &j : batch)
+                j.func();
+            batch.clear();
+        }
+    }
+
+    void join() {
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    const size_t max_batch;
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<job> queue;
+    statistics counters;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
+#endif
+
 NAMESPACE_END(pybind11)
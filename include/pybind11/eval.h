@@ -12,6 +12,7 @@
 #pragma once
 
 #include "pybind11.h"
+#include <list>
 
 NAMESPACE_BEGIN(pybind11)
 
@@ -26,22 +27,43 @@ enum eval_mode {
     eval_statements
 };
 
+NAMESPACE_BEGIN(detail)
+inline int eval_start(eval_mode mode) {
+    switch (mode) {
+        case eval_expr:             return Py_eval_input;
+        case eval_single_statement: return Py_single_input;
+        case eval_statements:       return Py_file_input;
+        default: pybind11_fail("invalid evaluation mode");
+    }
+}
+
+/* PyRun_String does not accept a PyObject / encoding specifier,
+   this seems to be the only alternative */
+inline std::string eval_source(const std::string &expr) {
+    return "# -*- coding: utf-8 -*-\n" + expr;
+}
+
+/// Removes common leading whitespace from raw string literals starting with a newline
+template <size_t N> str eval_dedent(const char (&s)[N]) {
+    return (s[0] == '\n') ? str(module::import("textwrap").attr("dedent")(s)) : str(s);
+}
+
+inline PyObject *compile_source(const std::string &expr, eval_mode mode, const char *filename) {
+    std::string buffer = eval_source(expr);
+    PyObject *code = Py_CompileString(buffer.c_str(), filename, eval_start(mode));
+    if (!code)
+        throw error_already_set();
+    return code;
+}
+NAMESPACE_END(detail)
+
 template <eval_mode mode = eval_expr>
 object eval(str expr, object global = globals(), object local = object()) {
     if (!local)
         local = global;
 
-    /* PyRun_String does not accept a PyObject / encoding specifier,
-       this seems to be the only alternative */
-    std::string buffer = "# -*- coding: utf-8 -*-\n" + (std::string) expr;
-
-    int start;
-    switch (mode) {
-        case eval_expr:             start = Py_eval_input;   break;
-        case eval_single_statement: start = Py_single_input; break;
-        case eval_statements:       start = Py_file_input;   break;
-        default: pybind11_fail("invalid evaluation mode");
-    }
+    std::string buffer = detail::eval_source(expr);
+    int start = detail::eval_start(mode);
 
     PyObject *result = PyRun_String(buffer.c_str(), start, global.ptr(), local.ptr());
     if (!result)
@@ -52,9 +74,7 @@ object eval(str expr, object global = globals(), object local = object()) {
 template <eval_mode mode = eval_expr, size_t N>
 object eval(const char (&s)[N], object global = globals(), object local = object()) {
     /* Support raw string literals by removing common leading whitespace */
-    auto expr = (s[0] == '\n') ? str(module::import("textwrap").attr("dedent")(s))
-                               : str(s);
-    return eval<mode>(expr, global, local);
+    return eval<mode>(detail::eval_dedent(s), global, local);
 }
 
 inline void exec(str expr, object global = globals(), object local = object()) {
@@ -66,18 +86,161 @@ void exec(const char (&s)[N], object global = globals(), object local = object()
     eval<eval_statements>(s, global, local);
 }
 
+/// A Python code object, compiled once by `compile()` and evaluated any number of times
+class compiled_code : public object {
+    PYBIND11_OBJECT_COMMON(compiled_code, object, PyCode_Check)
+    compiled_code() : object() { }
+    /* Deliberately 'explicit' (unlike most wrappers), so that passing a generic object to
+       eval()/exec() keeps selecting the overload that takes source text */
+    explicit compiled_code(const object &o) : object(o) { }
+};
+
+/// Compiles a string without evaluating it; see `eval()` for the meaning of `mode`
+template <eval_mode mode = eval_expr>
+compiled_code compile(str expr, const char *filename = "<string>") {
+    return reinterpret_steal<compiled_code>(detail::compile_source(expr, mode, filename));
+}
+
+template <eval_mode mode = eval_expr, size_t N>
+compiled_code compile(const char (&s)[N], const char *filename = "<string>") {
+    return compile<mode>(detail::eval_dedent(s), filename);
+}
+
+/// Evaluates previously compiled code. The evaluation mode was fixed by `compile()`; the template
+/// parameter is accepted (and ignored) so that `eval<mode>(...)` works for source and code alike.
+template <eval_mode mode = eval_expr>
+object eval(const compiled_code &code, object global = globals(), object local = object()) {
+    if (!local)
+        local = global;
+
+    /* Like PyRun_String, make the builtins available to code run in a fresh namespace */
+    if (PyDict_Check(global.ptr()) && !PyDict_GetItemString(global.ptr(), "__builtins__"))
+        PyDict_SetItemString(global.ptr(), "__builtins__", PyEval_GetBuiltins());
+
+#if PY_MAJOR_VERSION >= 3
+    PyObject *result = PyEval_EvalCode(code.ptr(), global.ptr(), local.ptr());
+#else
+    PyObject *result = PyEval_EvalCode((PyCodeObject *) code.ptr(), global.ptr(), local.ptr());
+#endif
+    if (!result)
+        throw error_already_set();
+    return reinterpret_steal<object>(result);
+}
+
+inline void exec(const compiled_code &code, object global = globals(), object local = object()) {
+    eval(code, global, local);
+}
+
+/** \rst
+    A bounded cache of compiled code, keyed by source text and evaluation mode. Evaluating the
+    same strings repeatedly through a cache skips parsing and compiling them (and, for raw string
+    literals, dedenting them) after the first time. When more than ``max_size`` entries are
+    cached, the least recently used one is discarded.
+
+    .. code-block:: cpp
+
+        py::code_cache cache(512);
+        auto result = cache.eval("price * qty > limit", scope);
+
+    The cache holds references to Python objects: access requires the GIL, and the cache must not
+    outlive the interpreter.
+\endrst */
+class code_cache {
+public:
+    explicit code_cache(size_t max_size = 256) : m_max_size(max_size) { }
+
+    template <eval_mode mode = eval_expr>
+    compiled_code compile(str expr) {
+        auto source = (std::string) expr;
+        return lookup(mode, source, [&]() { return detail::compile_source(source, mode, "<string>"); });
+    }
+
+    template <eval_mode mode = eval_expr, size_t N>
+    compiled_code compile(const char (&s)[N]) {
+        return lookup(mode, std::string(s), [&]() {
+            return detail::compile_source(detail::eval_dedent(s), mode, "<string>");
+        });
+    }
+
+    template <eval_mode mode = eval_expr>
+    object eval(str expr, object global = globals(), object local = object()) {
+        return pybind11::eval(compile<mode>(expr), global, local);
+    }
+
+    template <eval_mode mode = eval_expr, size_t N>
+    object eval(const char (&s)[N], object global = globals(), object local = object()) {
+        return pybind11::eval(compile<mode>(s), global, local);
+    }
+
+    void exec(str expr, object global = globals(), object local = object()) {
+        eval<eval_statements>(expr, global, local);
+    }
+
+    template <size_t N>
+    void exec(const char (&s)[N], object global = globals(), object local = object()) {
+        eval<eval_statements>(s, global, local);
+    }
+
+    /// Number of lookups that found compiled code in the cache
+    size_t hits() const { return m_hits; }
+    /// Number of lookups that had to compile the source
+    size_t misses() const { return m_misses; }
+    /// Number of entries discarded to respect the size bound
+    size_t evictions() const { return m_evictions; }
+
+    size_t size() const { return m_entries.size(); }
+    size_t max_size() const { return m_max_size; }
+
+    /// Changes the size bound, discarding the least recently used entries if necessary
+    void set_max_size(size_t max_size) { m_max_size = max_size; trim(); }
+
+    /// Discards all entries and resets the statistics
+    void clear() {
+        m_index.clear();
+        m_entries.clear();
+        m_hits = m_misses = m_evictions = 0;
+    }
+
+private:
+    using entry = std::pair<std::string, compiled_code>;
+
+    template <typename Compile>
+    compiled_code lookup(eval_mode mode, const std::string &source, Compile &&compile_code) {
+        std::string key = (char) ('0' + (int) mode) + source;
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            ++m_hits;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->second;
+        }
+        ++m_misses;
+        auto code = reinterpret_steal<compiled_code>(compile_code());
+        m_entries.emplace_front(std::move(key), code);
+        m_index.emplace(m_entries.front().first, m_entries.begin());
+        trim();
+        return code;
+    }
+
+    void trim() {
+        while (m_entries.size() > m_max_size) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+            ++m_evictions;
+        }
+    }
+
+    size_t m_max_size;
+    size_t m_hits = 0, m_misses = 0, m_evictions = 0;
+    std::list<entry> m_entries; // most recently used first
+    std::unordered_map<std::string, std::list<entry>::iterator> m_index;
+};
+
 template <eval_mode mode = eval_statements>
 object eval_file(str fname, object global = globals(), object local = object()) {
     if (!local)
         local = global;
 
-    int start;
-    switch (mode) {
-        case eval_expr:             start = Py_eval_input;   break;
-        case eval_single_statement: start = Py_single_input; break;
-        case eval_statements:       start = Py_file_input;   break;
-        default: pybind11_fail("invalid evaluation mode");
-    }
+    int start = detail::eval_start(mode);
 
     int closeFile = 1;
     std::string fname_str = (std::string) fname;
@@ -40,6 +40,7 @@ class array; // Forward declaration
 
 NAMESPACE_BEGIN(detail)
 template <typename type, typename SFINAE = void> struct npy_format_descriptor;
+template <typename type, typename SFINAE = void> struct dtype_ptr_cache;
 
 struct PyArrayDescr_Proxy {
     PyObject_HEAD
@@ -82,6 +83,7 @@ struct numpy_type_info {
 
 struct numpy_internals {
     std::unordered_map<std::type_index, numpy_type_info> registered_dtypes;
+    std::array<PyObject *, 32> builtin_dtypes{}; // Descriptors of the builtin types, by type number
 
     numpy_type_info *get_type_info(const std::type_info& tinfo, bool throw_if_missing = true) {
         auto it = registered_dtypes.find(std::type_index(tinfo));
@@ -221,6 +223,20 @@ private:
     }
 };
 
+/// Borrowed reference to the descriptor of a builtin NumPy type, looked up only once
+inline PyObject *builtin_dtype_ptr(int type_num) {
+    auto &dtypes = get_numpy_internals().builtin_dtypes;
+    if (type_num < 0 || type_num >= (int) dtypes.size())
+        pybind11_fail("Unsupported buffer format!");
+    auto &ptr = dtypes[(size_t) type_num];
+    if (!ptr) {
+        ptr = npy_api::get().PyArray_DescrFromType_(type_num); // Reference kept by the cache
+        if (!ptr)
+            pybind11_fail("Unsupported buffer format!");
+    }
+    return ptr;
+}
+
 inline PyArray_Proxy* array_proxy(void* ptr) {
     return reinterpret_cast<PyArray_Proxy*>(ptr);
 }
@@ -451,7 +467,7 @@ public:
 
     /// Return dtype associated with a C++ type.
     template <typename T> static dtype of() {
-        return detail::npy_format_descriptor<typename std::remove_cv<T>::type>::dtype();
+        return reinterpret_borrow<dtype>(detail::dtype_ptr_cache<typename std::remove_cv<T>::type>::get());
     }
 
     /// Size of the data type in bytes.
@@ -902,8 +918,12 @@ public:
 
     static bool check_(handle h) {
         const auto &api = detail::npy_api::get();
-        return api.PyArray_Check_(h.ptr())
-               && api.PyArray_EquivTypes_(detail::array_proxy(h.ptr())->descr, dtype::of<T>().ptr());
+        if (!api.PyArray_Check_(h.ptr()))
+            return false;
+        // Arrays of builtin types in native byte order share a single descriptor
+        PyObject *descr = detail::array_proxy(h.ptr())->descr;
+        PyObject *expected = detail::dtype_ptr_cache<typename std::remove_cv<T>::type>::get();
+        return descr == expected || api.PyArray_EquivTypes_(descr, expected);
     }
 
 protected:
@@ -971,7 +991,10 @@ struct pyobject_caster<array_t<T, ExtraFlags>> {
 template <typename T>
 struct compare_buffer_info<T, detail::enable_if_t<detail::is_pod_struct<T>::value>> {
     static bool compare(const buffer_info& b) {
-        return npy_api::get().PyArray_EquivTypes_(dtype::of<T>().ptr(), dtype(b).ptr());
+        // Buffers exported by pybind11 for `T` carry exactly the registered format string
+        if (b.itemsize == (ssize_t) sizeof(T) && b.format == npy_format_descriptor<T>::format())
+            return true;
+        return npy_api::get().PyArray_EquivTypes_(dtype_ptr_cache<T>::get(), dtype(b).ptr());
     }
 };
 
@@ -989,11 +1012,8 @@ private:
 public:
     static constexpr int value = values[detail::is_fmt_numeric<T>::index];
 
-    static pybind11::dtype dtype() {
-        if (auto ptr = npy_api::get().PyArray_DescrFromType_(value))
-            return reinterpret_borrow<pybind11::dtype>(ptr);
-        pybind11_fail("Unsupported buffer format!");
-    }
+    static pybind11::dtype dtype() { return reinterpret_borrow<pybind11::dtype>(dtype_ptr()); }
+    static PyObject *dtype_ptr() { return builtin_dtype_ptr(value); }
     template <typename T2 = T, enable_if_t<std::is_integral<T2>::value, int> = 0>
     static PYBIND11_DESCR name() {
         return _<std::is_same<T, bool>::value>(_("bool"),
@@ -1108,6 +1128,85 @@ inline PYBIND11_NOINLINE void register_structured_dtype(
     get_internals().direct_conversions[tindex].push_back(direct_converter);
 }
 
+/// Creates a one-dimensional structured array holding a copy of `size` records of type `dtype_ptr`
+inline PyObject *records_to_array(PyObject *dtype_ptr, const void *data, size_t size) {
+    try {
+        return array(reinterpret_borrow<pybind11::dtype>(dtype_ptr), (ssize_t) size, size ? data : nullptr)
+            .release().ptr();
+    } catch (error_already_set &e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+/* Loads a one-dimensional structured array into contiguous records of type `dtype_ptr`. Arrays of
+   an equivalent dtype are copied with a single memcpy (per record if they are strided). When
+   converting, other structured arrays are copied field by field, matching fields by name, which
+   handles different field orders, padding and additional fields; the fields themselves must have
+   equivalent dtypes. Anything else is left to the element-wise conversion. */
+inline bool array_to_records(PyObject *dtype_ptr, PyObject *src, bool convert, void *dst,
+                             void *(*resize)(void *, size_t)) {
+    auto &api = npy_api::get();
+    if (!api.PyArray_Check_(src))
+        return false;
+    auto arr = reinterpret_borrow<array>(src);
+    if (arr.ndim() != 1)
+        return false;
+
+    auto target = reinterpret_borrow<pybind11::dtype>(dtype_ptr);
+    auto source = arr.dtype();
+    size_t size = (size_t) arr.shape(0);
+    size_t itemsize = (size_t) target.itemsize();
+    ssize_t stride = arr.strides(0);
+    auto in = static_cast<const char *>(arr.data());
+
+    if (api.PyArray_EquivTypes_(dtype_ptr, source.ptr())) {
+        auto out = static_cast<char *>(resize(dst, size));
+        if (stride == (ssize_t) itemsize) {
+            if (size)
+                std::memcpy(out, in, size * itemsize);
+        } else {
+            for (size_t i = 0; i < size; ++i)
+                std::memcpy(out + i * itemsize, in + (ssize_t) i * stride, itemsize);
+        }
+        return true;
+    }
+    if (!convert || !source.has_fields())
+        return false;
+
+    struct field_copy { size_t from, to, size; };
+    std::vector<field_copy> plan;
+    auto source_fields = source.attr("fields").cast<dict>();
+    for (auto field : target.attr("fields").cast<dict>()) {
+        if (!source_fields.contains(field.first))
+            return false;
+        auto to = field.second.cast<tuple>(), from = source_fields[field.first].cast<tuple>();
+        if (!api.PyArray_EquivTypes_(to[0].ptr(), from[0].ptr()))
+            return false;
+        plan.push_back({from[1].cast<size_t>(), to[1].cast<size_t>(),
+                        (size_t) to[0].cast<pybind11::dtype>().itemsize()});
+    }
+    // Fields which are adjacent in both records are copied together
+    std::sort(plan.begin(), plan.end(), [](const field_copy &a, const field_copy &b) { return a.to < b.to; });
+    std::vector<field_copy> merged;
+    for (auto &copy : plan) {
+        if (!merged.empty() && merged.back().from + merged.back().size == copy.from &&
+                merged.back().to + merged.back().size == copy.to)
+            merged.back().size += copy.size;
+        else
+            merged.push_back(copy);
+    }
+
+    auto out = static_cast<char *>(resize(dst, size));
+    for (size_t i = 0; i < size; ++i) {
+        auto record_in = in + (ssize_t) i * stride;
+        auto record_out = out + i * itemsize;
+        for (auto &copy : merged)
+            std::memcpy(record_out + copy.to, record_in + copy.from, copy.size);
+    }
+    return true;
+}
+
 template <typename T, typename SFINAE> struct npy_format_descriptor {
     static_assert(is_pod_struct<T>::value, "Attempt to use a non-POD or unimplemented POD type as a numpy dtype");
 
@@ -1122,17 +1221,17 @@ template <typename T, typename SFINAE> struct npy_format_descriptor {
         return format_str;
     }
 
+    static PyObject* dtype_ptr() {
+        static PyObject* ptr = get_numpy_internals().get_type_info<T>(true)->dtype_ptr;
+        return ptr;
+    }
+
     static void register_dtype(const std::initializer_list<field_descriptor>& fields) {
         register_structured_dtype(fields, typeid(typename std::remove_cv<T>::type),
                                   sizeof(T), &direct_converter);
     }
 
 private:
-    static PyObject* dtype_ptr() {
-        static PyObject* ptr = get_numpy_internals().get_type_info<T>(true)->dtype_ptr;
-        return ptr;
-    }
-
     static bool direct_converter(PyObject *obj, void*& value) {
         auto& api = npy_api::get();
         if (!PyObject_TypeCheck(obj, api.PyVoidArrType_Type_))
@@ -1147,6 +1246,74 @@ private:
     }
 };
 
+/// Borrowed pointer to the dtype of `T`: provided by descriptors which resolve it only once
+/// (builtin and registered types); the dtypes of other descriptors are created once and kept
+template <typename T, typename SFINAE> struct dtype_ptr_cache {
+    static PyObject *get() {
+        static PyObject *ptr = npy_format_descriptor<T>::dtype().release().ptr();
+        return ptr;
+    }
+};
+
+template <typename T>
+struct dtype_ptr_cache<T, void_t<decltype(npy_format_descriptor<T>::dtype_ptr())>> {
+    static PyObject *get() { return npy_format_descriptor<T>::dtype_ptr(); }
+};
+
+NAMESPACE_END(detail)
+
+/** \rst
+    A ``std::vector`` of records of a type registered with ``PYBIND11_NUMPY_DTYPE``, which is
+    converted to and from a one-dimensional structured array as a whole rather than element by
+    element. Using it in place of ``std::vector<T>`` opts in to the bulk conversion for a single
+    function; plain vectors of the same type are not affected.
+\endrst */
+template <typename T, typename Alloc = std::allocator<T>>
+class structured_vector : public std::vector<T, Alloc> {
+public:
+    using std::vector<T, Alloc>::vector;
+    structured_vector() = default;
+    structured_vector(std::vector<T, Alloc> v) : std::vector<T, Alloc>(std::move(v)) { }
+};
+
+NAMESPACE_BEGIN(detail)
+
+template <typename T, typename Alloc> struct type_caster<structured_vector<T, Alloc>> {
+    using Type = structured_vector<T, Alloc>;
+
+    bool load(handle src, bool convert) {
+        if (array_to_records(npy_format_descriptor<T>::dtype_ptr(), src.ptr(), convert, &value, &resize))
+            return true;
+        // Other sequences (e.g. of `numpy.void` records) are converted element by element
+        if (!isinstance<sequence>(src) || isinstance<array>(src))
+            return false;
+        auto s = reinterpret_borrow<sequence>(src);
+        value.clear();
+        value.reserve(s.size());
+        for (auto it : s) {
+            make_caster<T> conv;
+            if (!conv.load(it, convert))
+                return false;
+            value.push_back(cast_op<T &>(conv));
+        }
+        return true;
+    }
+
+    static handle cast(const Type &src, return_value_policy /* policy */, handle /* parent */) {
+        return records_to_array(npy_format_descriptor<T>::dtype_ptr(), src.data(), src.size());
+    }
+
+    PYBIND11_TYPE_CASTER(Type, _("numpy.ndarray[") + npy_format_descriptor<T>::name() + _("]"));
+
+private:
+    static void *resize(void *dst, size_t size) {
+        auto &value = *static_cast<Type *>(dst);
+        value.clear();
+        value.resize(size);
+        return value.data();
+    }
+};
+
 #ifdef __CLION_IDE__ // replace heavy macro with dummy code for the IDE (doesn't affect code)
 # define PYBIND11_NUMPY_DTYPE(Type, ...) ((void)0)
 # define PYBIND11_NUMPY_DTYPE_EX(Type, ...) ((void)0)
@@ -1339,6 +1506,110 @@ private:
     std::array<common_iter, N> m_common_iterator;
 };
 
+// Returns the byte strides of `buffer` when broadcast to `shape`: dimensions that the buffer
+// lacks or in which it has extent 1 (while the broadcast shape does not) get a stride of 0.
+inline std::vector<ssize_t> broadcast_strides(const buffer_info &buffer, const std::vector<ssize_t> &shape) {
+    std::vector<ssize_t> strides(shape.size(), 0);
+    auto offset = shape.size() - buffer.shape.size();
+    for (size_t i = 0; i < buffer.shape.size(); ++i)
+        if (buffer.shape[i] == shape[offset + i])
+            strides[offset + i] = buffer.strides[i];
+    return strides;
+}
+
+/* Iterates N operands over a common broadcast shape, in the manner of NumPy's nditer: dimensions
+   of extent 1 are dropped, adjacent dimensions which every operand traverses contiguously are
+   coalesced, and the longest remaining dimension becomes the inner one.  `run` then calls `f` with
+   the current operand pointers from a tight loop that advances each pointer by a fixed byte stride
+   (0 for broadcast operands), only updating the outer index between inner loops. */
+template <size_t N> class broadcast_loop {
+public:
+    using container_type = std::vector<ssize_t>;
+
+    broadcast_loop(const container_type &shape, const std::array<container_type, N> &strides) {
+        // Drop dimensions of extent 1, which never advance any operand
+        for (size_t d = 0; d < shape.size(); ++d) {
+            if (shape[d] == 1)
+                continue;
+            m_shape.push_back(shape[d]);
+            for (size_t k = 0; k < N; ++k)
+                m_strides[k].push_back(strides[k][d]);
+        }
+
+        // Coalesce a dimension into the one inside it when all operands step through them as one
+        for (size_t d = m_shape.size(); d > 1; --d) {
+            size_t outer = d - 2, inner = d - 1;
+            bool contiguous = true;
+            for (size_t k = 0; k < N && contiguous; ++k)
+                contiguous = m_strides[k][outer] == m_strides[k][inner] * m_shape[inner];
+            if (!contiguous)
+                continue;
+            m_shape[outer] *= m_shape[inner];
+            m_shape.erase(m_shape.begin() + (ssize_t) inner);
+            for (size_t k = 0; k < N; ++k) {
+                m_strides[k][outer] = m_strides[k][inner];
+                m_strides[k].erase(m_strides[k].begin() + (ssize_t) inner);
+            }
+        }
+
+        // Pull the longest dimension out as the inner loop (preferring the innermost one on ties);
+        // the rest keep their relative order
+        if (m_shape.empty()) {
+            m_inner_size = 1;
+            m_inner_strides.fill(0);
+            return;
+        }
+        size_t longest = m_shape.size() - 1;
+        for (size_t d = longest; d != 0; --d)
+            if (m_shape[d - 1] > m_shape[longest])
+                longest = d - 1;
+        m_inner_size = m_shape[longest];
+        m_shape.erase(m_shape.begin() + (ssize_t) longest);
+        for (size_t k = 0; k < N; ++k) {
+            m_inner_strides[k] = m_strides[k][longest];
+            m_strides[k].erase(m_strides[k].begin() + (ssize_t) longest);
+        }
+    }
+
+    // The extent of the inner loop and the number of dimensions iterated around it
+    ssize_t inner_size() const { return m_inner_size; }
+    size_t outer_ndim() const { return m_shape.size(); }
+
+    template <typename Func> void run(std::array<char *, N> ptrs, Func &&f) const {
+        container_type index(m_shape.size(), 0);
+        while (true) {
+            auto p = ptrs;
+            for (ssize_t i = 0; i < m_inner_size; ++i) {
+                f(p);
+                for (size_t k = 0; k < N; ++k)
+                    p[k] += m_inner_strides[k];
+            }
+
+            // Advance the outer index, rewinding any dimensions that wrap around
+            size_t d = m_shape.size();
+            for (; d != 0; --d) {
+                size_t j = d - 1;
+                if (++index[j] != m_shape[j]) {
+                    for (size_t k = 0; k < N; ++k)
+                        ptrs[k] += m_strides[k][j];
+                    break;
+                }
+                index[j] = 0;
+                for (size_t k = 0; k < N; ++k)
+                    ptrs[k] -= m_strides[k][j] * (m_shape[j] - 1);
+            }
+            if (d == 0)
+                return;
+        }
+    }
+
+private:
+    container_type m_shape;
+    std::array<container_type, N> m_strides;
+    ssize_t m_inner_size;
+    std::array<ssize_t, N> m_inner_strides;
+};
+
 enum class broadcast_trivial { non_trivial, c_trivial, f_trivial };
 
 // Populates the shape and number of dimensions for the set of buffers.  Returns a broadcast_trivial
@@ -1425,7 +1696,7 @@ struct vectorize_arg {
     using call_type = remove_reference_t<T>;
     // Is this a vectorized argument?
     static constexpr bool vectorize =
-        satisfies_any_of<call_type, std::is_arithmetic, is_complex, std::is_pod>::value &&
+        satisfies_any_of<remove_cv_t<call_type>, std::is_arithmetic, is_complex, std::is_pod>::value &&
         satisfies_none_of<call_type, std::is_pointer, std::is_array, is_std_array, std::is_enum>::value &&
         (!std::is_reference<T>::value ||
          (std::is_lvalue_reference<T>::value && std::is_const<call_type>::value));
@@ -1535,17 +1806,22 @@ private:
                          array_t<Return> &output_array,
                          index_sequence<Index...>, index_sequence<VIndex...>, index_sequence<BIndex...>) {
 
-        buffer_info output = output_array.request();
-        multi_array_iterator<NVectorized> input_iter(buffers, output.shape);
+        // The output is the last operand; the inputs get zero strides along their broadcast dimensions
+        std::vector<ssize_t> shape(output_array.shape(), output_array.shape() + output_array.ndim());
+        std::array<std::vector<ssize_t>, NVectorized + 1> strides{{
+            broadcast_strides(buffers[BIndex], shape)...,
+            std::vector<ssize_t>(output_array.strides(), output_array.strides() + output_array.ndim())
+        }};
+        std::array<char *, NVectorized + 1> ptrs{{
+            reinterpret_cast<char *>(buffers[BIndex].ptr)...,
+            reinterpret_cast<char *>(output_array.mutable_data())
+        }};
 
-        for (array_iterator<Return> iter = array_begin<Return>(output), end = array_end<Return>(output);
-             iter != end;
-             ++iter, ++input_iter) {
-            PYBIND11_EXPAND_SIDE_EFFECTS((
-                params[VIndex] = input_iter.template data<BIndex>()
-            ));
-            *iter = f(*reinterpret_cast<param_n_t<Index> *>(std::get<Index>(params))...);
-        }
+        broadcast_loop<NVectorized + 1>(shape, strides).run(ptrs, [&](const std::array<char *, NVectorized + 1> &p) {
+            PYBIND11_EXPAND_SIDE_EFFECTS(params[VIndex] = p[BIndex]);
+            *reinterpret_cast<Return *>(p[NVectorized]) =
+                f(*reinterpret_cast<param_n_t<Index> *>(std::get<Index>(params))...);
+        });
     }
 };
 
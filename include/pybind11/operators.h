@@ -10,6 +10,7 @@
 #pragma once
 
 #include "pybind11.h"
+#include <algorithm>
 
 #if defined(__clang__) && !defined(__INTEL_COMPILER)
 #  pragma clang diagnostic ignored "-Wunsequenced" // multiple unsequenced modifications to 'self' (when using def(py::self OP Type()))
@@ -49,6 +50,251 @@ inline self_t __self() { return self; }
 /// base template of operator implementations
 template <op_id, op_type, typename B, typename L, typename R> struct op_impl { };
 
+#if !defined(PYPY_VERSION)
+/// Whether `py::self OP py::self` for operator `id` has a native number slot (`nb_add` etc.), a
+/// unary number slot (`nb_negative` etc.) or is a comparison implemented by `tp_richcompare`
+constexpr bool is_inplace_op(op_id id) {
+    return id == op_iadd || id == op_isub || id == op_imul || id == op_itruediv || id == op_imod ||
+           id == op_ilshift || id == op_irshift || id == op_iand || id == op_ixor || id == op_ior;
+}
+constexpr bool has_binary_slot(op_id id) {
+    return id == op_add || id == op_sub || id == op_mul || id == op_truediv || id == op_mod ||
+           id == op_lshift || id == op_rshift || id == op_and || id == op_xor || id == op_or ||
+           is_inplace_op(id);
+}
+constexpr bool has_unary_slot(op_id id) {
+    return id == op_neg || id == op_pos || id == op_abs || id == op_invert;
+}
+constexpr int richcompare_op(op_id id) {
+    return id == op_lt ? Py_LT : id == op_le ? Py_LE : id == op_eq ? Py_EQ :
+           id == op_ne ? Py_NE : id == op_gt ? Py_GT : id == op_ge ? Py_GE : -1;
+}
+
+inline binaryfunc &binary_slot(PyTypeObject *type, op_id id) {
+    auto &n = *type->tp_as_number;
+    switch (id) {
+        case op_add:      return n.nb_add;
+        case op_sub:      return n.nb_subtract;
+        case op_mul:      return n.nb_multiply;
+        case op_truediv:  return n.nb_true_divide;
+        case op_mod:      return n.nb_remainder;
+        case op_lshift:   return n.nb_lshift;
+        case op_rshift:   return n.nb_rshift;
+        case op_and:      return n.nb_and;
+        case op_xor:      return n.nb_xor;
+        case op_or:       return n.nb_or;
+        case op_iadd:     return n.nb_inplace_add;
+        case op_isub:     return n.nb_inplace_subtract;
+        case op_imul:     return n.nb_inplace_multiply;
+        case op_itruediv: return n.nb_inplace_true_divide;
+        case op_imod:     return n.nb_inplace_remainder;
+        case op_ilshift:  return n.nb_inplace_lshift;
+        case op_irshift:  return n.nb_inplace_rshift;
+        case op_iand:     return n.nb_inplace_and;
+        case op_ixor:     return n.nb_inplace_xor;
+        case op_ior:      return n.nb_inplace_or;
+        default:          pybind11_fail("binary_slot(): operator has no number slot");
+    }
+}
+
+/// True if `type` fills the number slot of `id` with `slot` (types such as `list` have no number slots)
+inline bool uses_binary_slot(PyTypeObject *type, op_id id, binaryfunc slot) {
+    return type->tp_as_number && binary_slot(type, id) == slot;
+}
+
+inline unaryfunc &unary_slot(PyTypeObject *type, op_id id) {
+    auto &n = *type->tp_as_number;
+    switch (id) {
+        case op_neg:    return n.nb_negative;
+        case op_pos:    return n.nb_positive;
+        case op_abs:    return n.nb_absolute;
+        case op_invert: return n.nb_invert;
+        default:        pybind11_fail("unary_slot(): operator has no number slot");
+    }
+}
+
+/// Calls the special method `name` as found on the type of `self` (like CPython's own slot
+/// functions do); returns NotImplemented if the type doesn't define it.
+template <typename... Args> PyObject *call_special_method(PyObject *self, const interned &name, Args... args) {
+    PyObject *descr = _PyType_Lookup(Py_TYPE(self), name.ptr().ptr());
+    if (!descr)
+        return handle(Py_NotImplemented).inc_ref().ptr();
+    auto func = reinterpret_borrow<object>(descr);
+    if (auto get = Py_TYPE(descr)->tp_descr_get) {
+        func = reinterpret_steal<object>(get(descr, self, (PyObject *) Py_TYPE(self)));
+        if (!func)
+            return nullptr;
+    }
+    return PyObject_CallFunctionObjArgs(func.ptr(), args..., nullptr);
+}
+
+/** Native number slots and `tp_richcompare` for operators between two instances of the bound class
+    `Base`. When both operands are exactly of that type, the C++ operator is evaluated directly.
+    Otherwise the slot behaves like the generic one CPython installs for the `__op__` methods,
+    calling `__op__` or the reflected `__rop__` through the overload chain (and thus all other
+    overloads, subclasses overriding the method, ...). */
+template <typename Base> struct operator_slots {
+    using impl_t = PyObject *(*)(Base &, Base &);
+    using unary_impl_t = PyObject *(*)(Base &);
+
+    static PyTypeObject *&type() { static PyTypeObject *type = nullptr; return type; }
+
+    /// Functions applying the native slots to the type; these have to be reapplied whenever
+    /// defining an `__op__` method made CPython reset the slot to its generic implementation
+    static std::vector<void (*)(PyTypeObject *)> &installers() {
+        static std::vector<void (*)(PyTypeObject *)> installers;
+        return installers;
+    }
+
+    static void reinstall(handle cls) {
+        auto t = (PyTypeObject *) cls.ptr();
+        if (t != type())
+            return;
+        for (auto install : installers())
+            install(t);
+        PyType_Modified(t);
+    }
+
+    static void add_installer(void (*install)(PyTypeObject *)) {
+        auto &v = installers();
+        if (std::find(v.begin(), v.end(), install) == v.end())
+            v.push_back(install);
+    }
+
+    static Base *operand(PyObject *obj) {
+        if (Py_TYPE(obj) != type())
+            return nullptr;
+        return reinterpret_cast<Base *>(reinterpret_cast<instance *>(obj)->get_value_and_holder().value_ptr());
+    }
+
+    /// Converts the result of `f()` like `cpp_function` does for an operator's return value
+    template <typename Func> static PyObject *result(Func &&f) {
+        using Return = decltype(f());
+        try {
+            return make_caster<Return>::cast(f(),
+                return_value_policy_override<Return>::policy(return_value_policy::automatic), nullptr).ptr();
+        } catch (error_already_set &e) {
+            e.restore();
+        } catch (const std::exception &e) {
+            translate_exception(&typeid(e));
+        } catch (...) {
+            translate_exception(nullptr);
+        }
+        return nullptr;
+    }
+
+    template <op_id id, typename op> struct binary {
+        static impl_t &impl() { static impl_t impl = nullptr; return impl; }
+
+        static PyObject *slot(PyObject *a, PyObject *b) {
+            Base *l = operand(a), *r = l ? operand(b) : nullptr;
+            if (r)
+                return impl()(*l, *r);
+            return fallback(a, b, bool_constant<is_inplace_op(id)>());
+        }
+
+        /// In-place operators are only ever called on the left operand
+        static PyObject *fallback(PyObject *a, PyObject *b, std::true_type) {
+            static const interned name(op_impl<id, op_l, Base, Base, Base>::name());
+            return call_special_method(a, name, b);
+        }
+
+        /// The same slot is called for `a OP b` with either operand being of the bound type
+        static PyObject *fallback(PyObject *a, PyObject *b, std::false_type) {
+            static const interned name(op_impl<id, op_l, Base, Base, Base>::name());
+            static const interned rname(op_impl<id, op_r, Base, Base, Base>::name());
+            bool do_other = Py_TYPE(a) != Py_TYPE(b) && uses_binary_slot(Py_TYPE(b), id, &slot);
+            if (uses_binary_slot(Py_TYPE(a), id, &slot)) {
+                PyObject *result = call_special_method(a, name, b);
+                if (result != Py_NotImplemented || Py_TYPE(a) == Py_TYPE(b))
+                    return result;
+                Py_DECREF(result);
+            }
+            if (do_other)
+                return call_special_method(b, rname, a);
+            return handle(Py_NotImplemented).inc_ref().ptr();
+        }
+
+        static void install(PyTypeObject *t) { binary_slot(t, id) = slot; }
+    };
+
+    template <op_id id, typename op> struct unary {
+        static unary_impl_t &impl() { static unary_impl_t impl = nullptr; return impl; }
+
+        static PyObject *slot(PyObject *a) {
+            if (Base *l = operand(a))
+                return impl()(*l);
+            static const interned name(op_impl<id, op_u, Base, Base, undefined_t>::name());
+            return call_special_method(a, name);
+        }
+
+        static void install(PyTypeObject *t) { unary_slot(t, id) = slot; }
+    };
+
+    /// Native comparisons, indexed by `Py_LT` ... `Py_GE` (nullptr if only bound as a method)
+    static std::array<impl_t, 6> &compare() { static std::array<impl_t, 6> compare{}; return compare; }
+
+    static PyObject *richcompare(PyObject *a, PyObject *b, int op) {
+        impl_t impl = compare()[(size_t) op];
+        Base *l = impl ? operand(a) : nullptr, *r = l ? operand(b) : nullptr;
+        if (r)
+            return impl(*l, *r);
+        static const interned names[] = {
+            interned("__lt__"), interned("__le__"), interned("__eq__"),
+            interned("__ne__"), interned("__gt__"), interned("__ge__")
+        };
+        return call_special_method(a, names[op], b);
+    }
+
+    static void install_richcompare(PyTypeObject *t) { t->tp_richcompare = richcompare; }
+
+    template <op_id id, typename op> static void add_native(std::integral_constant<int, 1>) {
+        binary<id, op>::impl() = [](Base &l, Base &r) {
+            return result([&]() -> decltype(op::execute(l, r)) { return op::execute(l, r); });
+        };
+        add_installer(&binary<id, op>::install);
+    }
+    template <op_id id, typename op> static void add_native(std::integral_constant<int, 2>) {
+        unary<id, op>::impl() = [](Base &l) {
+            return result([&]() -> decltype(op::execute(l)) { return op::execute(l); });
+        };
+        add_installer(&unary<id, op>::install);
+    }
+    template <op_id id, typename op> static void add_native(std::integral_constant<int, 3>) {
+        compare()[(size_t) richcompare_op(id)] = [](Base &l, Base &r) {
+            return result([&]() -> decltype(op::execute(l, r)) { return op::execute(l, r); });
+        };
+        add_installer(&install_richcompare);
+    }
+    template <op_id, typename> static void add_native(std::integral_constant<int, 0>) { }
+
+    /// Called after `op` has been bound as a method of `cls`: gives it a native slot if it is an
+    /// operator between two `Base` instances (unless `native` is false), and restores the native
+    /// slots the definition may have replaced.
+    template <op_id id, op_type ot, typename op, typename L, typename R, typename Kind>
+    static void add(handle cls, bool native, Kind kind) {
+        if (!type())
+            type() = (PyTypeObject *) cls.ptr();
+        if (native)
+            add_native<id, op>(kind);
+        reinstall(cls);
+    }
+};
+
+/// The kind of native slot for the operator `op`: 0 (none), 1 (binary number slot), 2 (unary
+/// number slot) or 3 (comparison)
+template <op_id id, op_type ot, typename op, typename B, typename L, typename R, typename SFINAE = void>
+struct native_operator_kind : std::integral_constant<int, 0> { };
+template <op_id id, typename op, typename B>
+struct native_operator_kind<id, op_l, op, B, B, B, enable_if_t<
+        !std::is_void<decltype(op::execute(std::declval<B &>(), std::declval<B &>()))>::value>>
+    : std::integral_constant<int, richcompare_op(id) >= 0 ? 3 : has_binary_slot(id) ? 1 : 0> { };
+template <op_id id, typename op, typename B>
+struct native_operator_kind<id, op_u, op, B, B, undefined_t, enable_if_t<
+        !std::is_void<decltype(op::execute(std::declval<B &>()))>::value>>
+    : std::integral_constant<int, has_unary_slot(id) ? 2 : 0> { };
+#endif
+
 /// Operator implementation generator
 template <op_id id, op_type ot, typename L, typename R> struct op_ {
     template <typename Class, typename... Extra> void execute(Class &cl, const Extra&... extra) const {
@@ -62,6 +308,10 @@ template <op_id id, op_type ot, typename L, typename R> struct op_ {
             cl.def(id == op_itruediv ? "__idiv__" : ot == op_l ? "__div__" : "__rdiv__",
                     &op::execute, is_operator(), extra...);
         #endif
+        #if !defined(PYPY_VERSION)
+        operator_slots<Base>::template add<id, ot, op, L_type, R_type>(
+            cl, sizeof...(Extra) == 0, native_operator_kind<id, ot, op, Base, L_type, R_type>());
+        #endif
     }
     template <typename Class, typename... Extra> void execute_cast(Class &cl, const Extra&... extra) const {
         using Base = typename Class::type;
@@ -74,6 +324,9 @@ template <op_id id, op_type ot, typename L, typename R> struct op_ {
             cl.def(id == op_itruediv ? "__idiv__" : ot == op_l ? "__div__" : "__rdiv__",
                     &op::execute, is_operator(), extra...);
         #endif
+        #if !defined(PYPY_VERSION)
+        operator_slots<Base>::reinstall(cl);
+        #endif
     }
 };
 
@@ -43,8 +43,98 @@
 #include "attr.h"
 #include "options.h"
 #include "class_support.h"
+#include <algorithm>
 
 NAMESPACE_BEGIN(pybind11)
+NAMESPACE_BEGIN(detail)
+
+/** Translates the active C++ exception into a Python exception.
+
+    Each registered exception translator gets a chance to translate it in reverse order of
+    registration.  A translator may choose to do one of the following:
+
+     - catch the exception and call PyErr_SetString or PyErr_SetObject
+       to set a standard (or custom) Python exception, or
+     - do nothing and let the exception fall through to the next translator, or
+     - delegate translation to the next translator by throwing a new type of exception.
+
+    `type` is the dynamic type of the exception if it is known (i.e. for subclasses of
+    `std::exception`).  In that case, the typed translator (see `register_exception`) which ends
+    up handling it is cached, and all other typed translators are skipped for further exceptions
+    of the same type.  Generic translators are always invoked. */
+PYBIND11_NOINLINE inline void translate_exception(const std::type_info *type) {
+    auto &internals = get_internals();
+    auto &generic = internals.registered_exception_translators;
+    auto &typed = internals.registered_typed_exception_translators;
+    auto &cache = internals.typed_exception_translator_cache;
+    const size_t none = (size_t) -1;
+
+    size_t match = none;
+    bool cached = false;
+    if (type) {
+        auto it = cache.find(*type);
+        if (it != cache.end()) {
+            match = it->second;
+            cached = true;
+        }
+    }
+
+    // The cache only applies while the original exception is being translated
+    auto last_exception = std::current_exception();
+    bool original = true;
+
+    // Merge both translator lists in reverse order of registration
+    auto g = generic.begin();
+    size_t g_index = internals.generic_exception_translator_count; // One past the index of `*g`
+    size_t t = typed.size();
+    while (true) {
+        bool use_typed = t > 0 && (g == generic.end() || typed[t - 1].generic_before >= g_index);
+        if (!use_typed && g == generic.end())
+            break;
+
+        void (*translator)(std::exception_ptr);
+        if (use_typed) {
+            --t;
+            if (original && cached && t != match)
+                continue;
+            translator = typed[t].translator;
+        } else {
+            translator = *g++;
+            --g_index;
+        }
+
+        try {
+            translator(last_exception);
+        } catch (...) {
+            auto current = std::current_exception();
+            if (current != last_exception) {
+                last_exception = current;
+                original = false;
+            }
+            continue;
+        }
+
+        if (type && original && !cached) {
+            if (use_typed)
+                cache[*type] = t;
+            else if (t == 0)
+                cache[*type] = none;
+        }
+        return;
+    }
+    PyErr_SetString(PyExc_SystemError, "Exception escaped from default exception translator!");
+}
+
+/// Registers a translator which only handles a single C++ exception type (and its subclasses)
+PYBIND11_NOINLINE inline void register_typed_exception_translator(void (*translator)(std::exception_ptr)) {
+    auto &internals = get_internals();
+    internals.registered_typed_exception_translators.push_back(
+        typed_exception_translator{translator, internals.generic_exception_translator_count});
+    // A newly registered translator takes precedence, so previous resolutions are stale
+    internals.typed_exception_translator_cache.clear();
+}
+
+NAMESPACE_END(detail)
 
 /// Wraps an arbitrary C++ function/method/lambda function/.. into a callable Python object
 class cpp_function : public function {
@@ -157,6 +247,10 @@ protected:
             handle result = cast_out::cast(
                 std::move(args_converter).template call<Return, Guard>(cap->f), policy, call.parent);
 
+            /* A `py::value_or_error` return may have raised a Python exception without throwing */
+            if (detail::is_value_or_error<Return>::value && !result && PyErr_Occurred())
+                return PYBIND11_ERROR_RESULT;
+
             /* Invoke call policy post-call hook */
             detail::process_attributes<Extra...>::postcall(call, result);
 
@@ -166,9 +260,10 @@ protected:
         /* Process any user-provided function attributes */
         detail::process_attributes<Extra...>::init(extra..., rec);
 
-        /* Generate a readable signature describing the function's arguments and return value types */
+        /* Describe the function's arguments and return value types; the readable signature is only
+           generated from this when it is first needed */
         using detail::descr; using detail::_;
-        PYBIND11_DESCR signature = _("(") + cast_in::arg_names() + _(") -> ") + cast_out::name();
+        static PYBIND11_DESCR signature = _("(") + cast_in::arg_names() + _(") -> ") + cast_out::name();
 
         /* Register the function with Python from generic (non-templated) code */
         initialize_generic(rec, signature.text(), signature.types(), sizeof...(Args));
@@ -199,67 +294,10 @@ protected:
                 a.name = strdup(a.name);
             if (a.descr)
                 a.descr = strdup(a.descr);
-            else if (a.value)
-                a.descr = strdup(a.value.attr("__repr__")().cast<std::string>().c_str());
-        }
-
-        /* Generate a proper function signature */
-        std::string signature;
-        size_t type_depth = 0, char_index = 0, type_index = 0, arg_index = 0;
-        while (true) {
-            char c = text[char_index++];
-            if (c == '\0')
-                break;
-
-            if (c == '{') {
-                // Write arg name for everything except *args, **kwargs and return type.
-                if (type_depth == 0 && text[char_index] != '*' && arg_index < args) {
-                    if (!rec->args.empty() && rec->args[arg_index].name) {
-                        signature += rec->args[arg_index].name;
-                    } else if (arg_index == 0 && rec->is_method) {
-                        signature += "self";
-                    } else {
-                        signature += "arg" + std::to_string(arg_index - (rec->is_method ? 1 : 0));
-                    }
-                    signature += ": ";
-                }
-                ++type_depth;
-            } else if (c == '}') {
-                --type_depth;
-                if (type_depth == 0) {
-                    if (arg_index < rec->args.size() && rec->args[arg_index].descr) {
-                        signature += "=";
-                        signature += rec->args[arg_index].descr;
-                    }
-                    arg_index++;
-                }
-            } else if (c == '%') {
-                const std::type_info *t = types[type_index++];
-                if (!t)
-                    pybind11_fail("Internal error while parsing type signature (1)");
-                if (auto tinfo = detail::get_type_info(*t)) {
-#if defined(PYPY_VERSION)
-                    signature += handle((PyObject *) tinfo->type)
-                                     .attr("__module__")
-                                     .cast<std::string>() + ".";
-#endif
-                    signature += tinfo->type->tp_name;
-                } else {
-                    std::string tname(t->name());
-                    detail::clean_type_id(tname);
-                    signature += tname;
-                }
-            } else {
-                signature += c;
-            }
         }
-        if (type_depth != 0 || types[type_index] != nullptr)
-            pybind11_fail("Internal error while parsing type signature (2)");
 
-        #if !defined(PYBIND11_CONSTEXPR_DESCR)
-            delete[] types;
-            delete[] text;
-        #endif
+        rec->signature_text = text;
+        rec->signature_types = types;
 
 #if PY_MAJOR_VERSION < 3
         if (strcmp(rec->name, "__next__") == 0) {
@@ -270,8 +308,24 @@ protected:
             rec->name = strdup("__nonzero__");
         }
 #endif
-        rec->signature = strdup(signature.c_str());
         rec->args.shrink_to_fit();
+
+        /* Index the keyword arguments by their interned names: keys of keyword arguments in
+           calls are usually interned strings too, so the dispatcher can match them by pointer */
+        for (size_t i = 0; i < rec->args.size(); ++i) {
+            if (rec->args[i].name)
+                rec->keywords.emplace_back(interned(rec->args[i].name).ptr().ptr(), (std::uint16_t) i);
+        }
+        using keyword = std::pair<PyObject *, std::uint16_t>;
+        std::stable_sort(rec->keywords.begin(), rec->keywords.end(), [](const keyword &a, const keyword &b) {
+            return std::less<PyObject *>()(a.first, b.first);
+        });
+        // If a name is repeated, only its first position can be passed by keyword
+        rec->keywords.erase(std::unique(rec->keywords.begin(), rec->keywords.end(), [](const keyword &a, const keyword &b) {
+            return a.first == b.first;
+        }), rec->keywords.end());
+        rec->keywords.shrink_to_fit();
+
         rec->is_constructor = !strcmp(rec->name, "__init__") || !strcmp(rec->name, "__setstate__");
         rec->nargs = (std::uint16_t) args;
 
@@ -280,7 +334,7 @@ protected:
 
         detail::function_record *chain = nullptr, *chain_start = rec;
         if (rec->sibling) {
-            if (PyCFunction_Check(rec->sibling.ptr())) {
+            if (PyObject_TypeCheck(rec->sibling.ptr(), &PyCFunction_Type)) {
                 auto rec_capsule = reinterpret_borrow<capsule>(PyCFunction_GET_SELF(rec->sibling.ptr()));
                 chain = (detail::function_record *) rec_capsule;
                 /* Never append a method to an overload chain of a parent class;
@@ -329,7 +383,7 @@ protected:
                         "compile in debug mode for more details"
                     #else
                         "error while attempting to bind " + std::string(rec->is_method ? "instance" : "static") + " method " +
-                        std::string(pybind11::str(rec->scope.attr("__name__"))) + "." + std::string(rec->name) + signature
+                        std::string(pybind11::str(rec->scope.attr("__name__"))) + "." + std::string(rec->name) + signature(rec)
                     #endif
                 );
             while (chain->next)
@@ -337,52 +391,173 @@ protected:
             chain->next = rec;
         }
 
+        /* Install the docstring. Unless the function type can't be replaced (on PyPy), it is only
+           generated when `__doc__` is first accessed, and discarded when an overload is added */
+        rec->show_signature = options::show_function_signatures();
+        rec->show_doc = options::show_user_defined_docstrings();
+        auto &function_type = detail::get_internals().function_type;
+        if (!function_type)
+            function_type = detail::make_function_type(get_doc);
+        if (!chain && function_type)
+            m_ptr->ob_type = function_type;
+
+        PyCFunctionObject *func = (PyCFunctionObject *) m_ptr;
+        if (func->m_ml->ml_doc)
+            std::free(const_cast<char *>(func->m_ml->ml_doc));
+        func->m_ml->ml_doc = nullptr;
+        if (Py_TYPE(m_ptr) != function_type)
+            func->m_ml->ml_doc = strdup(docstring(chain_start).c_str());
+
+        if (rec->is_method) {
+            m_ptr = PYBIND11_INSTANCE_METHOD_NEW(m_ptr, rec->scope.ptr());
+            if (!m_ptr)
+                pybind11_fail("cpp_function::cpp_function(): Could not allocate instance method object");
+            Py_DECREF(func);
+        }
+    }
+
+    /// Creates a nice pydoc entry including all signatures and docstrings of the functions in the
+    /// overload chain starting at `head`
+    static std::string docstring(detail::function_record *head) {
+        // The options of the most recently added overload apply to the whole chain
+        auto tail = head;
+        while (tail->next)
+            tail = tail->next;
+        const bool show_signature = tail->show_signature, show_doc = tail->show_doc;
+        const bool overloaded = head->next != nullptr;
+
         std::string signatures;
         int index = 0;
-        /* Create a nice pydoc rec including all signatures and
-           docstrings of the functions in the overload chain */
-        if (chain && options::show_function_signatures()) {
+        if (overloaded && show_signature) {
             // First a generic signature
-            signatures += rec->name;
+            signatures += head->name;
             signatures += "(*args, **kwargs)\n";
             signatures += "Overloaded function.\n\n";
         }
         // Then specific overload signatures
         bool first_user_def = true;
-        for (auto it = chain_start; it != nullptr; it = it->next) {
-            if (options::show_function_signatures()) {
+        for (auto it = head; it != nullptr; it = it->next) {
+            if (show_signature) {
                 if (index > 0) signatures += "\n";
-                if (chain)
+                if (overloaded)
                     signatures += std::to_string(++index) + ". ";
-                signatures += rec->name;
-                signatures += it->signature;
+                signatures += head->name;
+                signatures += signature(it);
                 signatures += "\n";
             }
-            if (it->doc && strlen(it->doc) > 0 && options::show_user_defined_docstrings()) {
+            if (it->doc && strlen(it->doc) > 0 && show_doc) {
                 // If we're appending another docstring, and aren't printing function signatures, we
                 // need to append a newline first:
-                if (!options::show_function_signatures()) {
+                if (!show_signature) {
                     if (first_user_def) first_user_def = false;
                     else signatures += "\n";
                 }
-                if (options::show_function_signatures()) signatures += "\n";
+                if (show_signature) signatures += "\n";
                 signatures += it->doc;
-                if (options::show_function_signatures()) signatures += "\n";
+                if (show_signature) signatures += "\n";
             }
         }
+        return signatures;
+    }
+
+    /// `__doc__` of the function objects created by `cpp_function`: generates the docstring on
+    /// first access
+    static PyObject *get_doc(PyObject *self, void *) {
+        auto func = (PyCFunctionObject *) self;
+        if (!func->m_ml->ml_doc) {
+            try {
+                auto head = (detail::function_record *) reinterpret_borrow<capsule>(PyCFunction_GET_SELF(self));
+                func->m_ml->ml_doc = strdup(docstring(head).c_str());
+            } catch (error_already_set &e) {
+                e.restore();
+                return nullptr;
+            } catch (const std::exception &e) {
+                PyErr_SetString(PyExc_RuntimeError, e.what());
+                return nullptr;
+            }
+        }
+        if (!*func->m_ml->ml_doc)
+            return handle(Py_None).inc_ref().ptr();
+        return PYBIND11_FROM_STRING(func->m_ml->ml_doc);
+    }
 
-        /* Install docstring */
-        PyCFunctionObject *func = (PyCFunctionObject *) m_ptr;
-        if (func->m_ml->ml_doc)
-            std::free(const_cast<char *>(func->m_ml->ml_doc));
-        func->m_ml->ml_doc = strdup(signatures.c_str());
+    /// Generates the human-readable signature of a function.  This is deferred until the signature
+    /// is first needed (for the docstring or an error message), since it is comparatively expensive.
+    PYBIND11_NOINLINE static const char *signature(detail::function_record *rec) {
+        if (rec->signature)
+            return rec->signature;
 
-        if (rec->is_method) {
-            m_ptr = PYBIND11_INSTANCE_METHOD_NEW(m_ptr, rec->scope.ptr());
-            if (!m_ptr)
-                pybind11_fail("cpp_function::cpp_function(): Could not allocate instance method object");
-            Py_DECREF(func);
+        /* Describe default arguments which don't have an explicit description */
+        for (auto &a: rec->args) {
+            if (a.descr || !a.value)
+                continue;
+            auto r = reinterpret_steal<object>(PyObject_Repr(a.value.ptr()));
+            if (r) {
+                a.descr = strdup(r.cast<std::string>().c_str());
+            } else {
+                PyErr_Clear();
+                a.descr = strdup("...");
+            }
         }
+
+        const char *text = rec->signature_text;
+        const std::type_info *const *types = rec->signature_types;
+        size_t args = rec->nargs;
+
+        std::string signature;
+        size_t type_depth = 0, char_index = 0, type_index = 0, arg_index = 0;
+        while (true) {
+            char c = text[char_index++];
+            if (c == '\0')
+                break;
+
+            if (c == '{') {
+                // Write arg name for everything except *args, **kwargs and return type.
+                if (type_depth == 0 && text[char_index] != '*' && arg_index < args) {
+                    if (!rec->args.empty() && rec->args[arg_index].name) {
+                        signature += rec->args[arg_index].name;
+                    } else if (arg_index == 0 && rec->is_method) {
+                        signature += "self";
+                    } else {
+                        signature += "arg" + std::to_string(arg_index - (rec->is_method ? 1 : 0));
+                    }
+                    signature += ": ";
+                }
+                ++type_depth;
+            } else if (c == '}') {
+                --type_depth;
+                if (type_depth == 0) {
+                    if (arg_index < rec->args.size() && rec->args[arg_index].descr) {
+                        signature += "=";
+                        signature += rec->args[arg_index].descr;
+                    }
+                    arg_index++;
+                }
+            } else if (c == '%') {
+                const std::type_info *t = types[type_index++];
+                if (!t)
+                    pybind11_fail("Internal error while parsing type signature (1)");
+                if (auto tinfo = detail::get_type_info(*t)) {
+#if defined(PYPY_VERSION)
+                    signature += handle((PyObject *) tinfo->type)
+                                     .attr("__module__")
+                                     .cast<std::string>() + ".";
+#endif
+                    signature += tinfo->type->tp_name;
+                } else {
+                    std::string tname(t->name());
+                    detail::clean_type_id(tname);
+                    signature += tname;
+                }
+            } else {
+                signature += c;
+            }
+        }
+        if (type_depth != 0 || types[type_index] != nullptr)
+            pybind11_fail("Internal error while parsing type signature (2)");
+
+        rec->signature = strdup(signature.c_str());
+        return rec->signature;
     }
 
     /// When a cpp_function is GCed, release any memory allocated by pybind11
@@ -408,6 +583,40 @@ protected:
         }
     }
 
+    /// Returns the position of the keyword argument named `key`, or `(size_t) -1` if there is none
+    static size_t keyword_position(const detail::function_record &func, PyObject *key) {
+        using keyword = std::pair<PyObject *, std::uint16_t>;
+        auto find = [&func](PyObject *name) {
+            auto it = std::lower_bound(func.keywords.begin(), func.keywords.end(), name,
+                                       [](const keyword &a, PyObject *b) { return std::less<PyObject *>()(a.first, b); });
+            return it != func.keywords.end() && it->first == name ? (size_t) it->second : (size_t) -1;
+        };
+
+        size_t position = find(key);
+        if (position != (size_t) -1 || func.keywords.empty())
+            return position;
+
+        // The key may be an equal string which isn't interned (e.g. when it was built at runtime)
+#if PY_MAJOR_VERSION >= 3
+        const char *name = PyUnicode_Check(key) ? PyUnicode_AsUTF8(key) : nullptr;
+#else
+        // Unicode keys (e.g. `f(**{u'name': 1})`) are looked up by their UTF-8 encoding
+        object encoded;
+        if (PyUnicode_Check(key)) {
+            encoded = reinterpret_steal<object>(PyUnicode_AsUTF8String(key));
+            key = encoded.ptr();
+        }
+        const char *name = key && PyString_Check(key) ? PyString_AS_STRING(key) : nullptr;
+#endif
+        if (!name) {
+            PyErr_Clear();
+            return position;
+        }
+        auto &names = detail::get_internals().interned_names;
+        auto it = names.find(name);
+        return it != names.end() && it->second != key ? find(it->second) : position;
+    }
+
     /// Main dispatch logic for calls to functions bound using pybind11
     static PyObject *dispatcher(PyObject *self, PyObject *args_in, PyObject *kwargs_in) {
         using namespace detail;
@@ -418,6 +627,7 @@ protected:
 
         /* Need to know how many arguments + keyword arguments there are to pick the right overload */
         const size_t n_args_in = (size_t) PyTuple_GET_SIZE(args_in);
+        const size_t n_kwargs_in = kwargs_in ? (size_t) PyDict_Size(kwargs_in) : 0;
 
         handle parent = n_args_in > 0 ? PyTuple_GET_ITEM(args_in, 0) : nullptr,
                result = PYBIND11_TRY_NEXT_OVERLOAD;
@@ -432,17 +642,20 @@ protected:
             // However, if there are no overloads, we can just skip the no-convert pass entirely
             const bool overloaded = it != nullptr && it->next != nullptr;
 
+            // Values of the keyword arguments, indexed by their position in the called overload
+            std::vector<handle> kwarg_values;
+
             for (; it != nullptr; it = it->next) {
 
                 /* For each overload:
-                   1. Copy all positional arguments we were given, also checking to make sure that
-                      named positional arguments weren't *also* specified via kwarg.
-                   2. If we weren't given enough, try to make up the omitted ones by checking
-                      whether they were provided by a kwarg matching the `py::arg("name")` name.  If
-                      so, use it (and remove it from kwargs; if not, see if the function binding
-                      provided a default that we can use.
-                   3. Ensure that either all keyword arguments were "consumed", or that the function
-                      takes a kwargs argument to accept unconsumed kwargs.
+                   1. Copy all positional arguments we were given.
+                   2. Match each given kwarg to the position of the `py::arg("name")` with its name,
+                      making sure that named positional arguments weren't *also* specified via
+                      kwarg, and that either all kwargs were matched ("consumed"), or that the
+                      function takes a kwargs argument to accept unconsumed kwargs.
+                   3. If we weren't given enough positional arguments, make up the omitted ones
+                      from the matched kwargs and, failing that, from the defaults provided by the
+                      function binding.
                    4. Any positional arguments still left get put into a tuple (for args), and any
                       leftover kwargs get put into a dict.
                    5. Pack everything into a vector; if we have py::args or py::kwargs, they are an
@@ -473,11 +686,6 @@ protected:
                 bool bad_arg = false;
                 for (; args_copied < args_to_copy; ++args_copied) {
                     argument_record *arg_rec = args_copied < func.args.size() ? &func.args[args_copied] : nullptr;
-                    if (kwargs_in && arg_rec && arg_rec->name && PyDict_GetItemString(kwargs_in, arg_rec->name)) {
-                        bad_arg = true;
-                        break;
-                    }
-
                     handle arg(PyTuple_GET_ITEM(args_in, args_copied));
                     if (arg_rec && !arg_rec->none && arg.is_none()) {
                         bad_arg = true;
@@ -489,46 +697,55 @@ protected:
                 if (bad_arg)
                     continue; // Maybe it was meant for another overload (issue #688)
 
-                // We'll need to copy this if we steal some kwargs for defaults
+                // 2. Match the kwargs to positions, going over the kwargs dict once
                 dict kwargs = reinterpret_borrow<dict>(kwargs_in);
-
-                // 2. Check kwargs and, failing that, defaults that may help complete the list
-                if (args_copied < pos_args) {
-                    bool copied_kwargs = false;
-
-                    for (; args_copied < pos_args; ++args_copied) {
-                        const auto &arg = func.args[args_copied];
-
-                        handle value;
-                        if (kwargs_in && arg.name)
-                            value = PyDict_GetItemString(kwargs.ptr(), arg.name);
-
-                        if (value) {
-                            // Consume a kwargs value
-                            if (!copied_kwargs) {
-                                kwargs = reinterpret_steal<dict>(PyDict_Copy(kwargs.ptr()));
-                                copied_kwargs = true;
-                            }
-                            PyDict_DelItemString(kwargs.ptr(), arg.name);
-                        } else if (arg.value) {
-                            value = arg.value;
+                if (n_kwargs_in > 0) {
+                    kwarg_values.assign(pos_args, handle());
+                    size_t consumed = 0;
+                    PyObject *key, *value;
+                    ssize_t pos = 0;
+                    while (PyDict_Next(kwargs_in, &pos, &key, &value)) {
+                        size_t position = keyword_position(func, key);
+                        if (position >= pos_args)
+                            continue;
+                        if (position < args_copied) {
+                            bad_arg = true; // Also given as a positional argument
+                            break;
                         }
-
-                        if (value) {
-                            call.args.push_back(value);
-                            call.args_convert.push_back(arg.convert);
+                        kwarg_values[position] = value;
+                        ++consumed;
+                    }
+                    if (bad_arg)
+                        continue; // Maybe it was meant for another overload (issue #688)
+                    if (consumed < n_kwargs_in && !func.has_kwargs)
+                        continue; // Unconsumed kwargs, but no py::kwargs argument to accept them
+
+                    // A py::kwargs argument receives a copy without the consumed kwargs
+                    if (consumed > 0 && func.has_kwargs) {
+                        kwargs = reinterpret_steal<dict>(PyDict_Copy(kwargs_in));
+                        for (size_t i = args_copied; i < pos_args; ++i) {
+                            if (kwarg_values[i] && PyDict_DelItemString(kwargs.ptr(), func.args[i].name) != 0)
+                                throw error_already_set();
                         }
-                        else
-                            break;
                     }
+                }
 
-                    if (args_copied < pos_args)
-                        continue; // Not enough arguments, defaults, or kwargs to fill the positional arguments
+                // 3. Fill in any remaining positional arguments from kwargs or defaults
+                for (; args_copied < pos_args; ++args_copied) {
+                    const auto &arg = func.args[args_copied];
+
+                    handle value = n_kwargs_in > 0 ? kwarg_values[args_copied] : handle();
+                    if (!value)
+                        value = arg.value;
+                    if (!value)
+                        break;
+
+                    call.args.push_back(value);
+                    call.args_convert.push_back(arg.convert);
                 }
 
-                // 3. Check everything was consumed (unless we have a kwargs arg)
-                if (kwargs && kwargs.size() > 0 && !func.has_kwargs)
-                    continue; // Unconsumed kwargs, but no py::kwargs argument to accept them
+                if (args_copied < pos_args)
+                    continue; // Not enough arguments, defaults, or kwargs to fill the positional arguments
 
                 // 4a. If we have a py::args argument, create a new tuple with leftovers
                 tuple extra_args;
@@ -619,34 +836,19 @@ protected:
         } catch (error_already_set &e) {
             e.restore();
             return nullptr;
-        } catch (...) {
+        } catch (const std::exception &e) {
             /* When an exception is caught, give each registered exception
-               translator a chance to translate it to a Python exception
-               in reverse order of registration.
-
-               A translator may choose to do one of the following:
-
-                - catch the exception and call PyErr_SetString or PyErr_SetObject
-                  to set a standard (or custom) Python exception, or
-                - do nothing and let the exception fall through to the next translator, or
-                - delegate translation to the next translator by throwing a new type of exception. */
-
-            auto last_exception = std::current_exception();
-            auto &registered_exception_translators = get_internals().registered_exception_translators;
-            for (auto& translator : registered_exception_translators) {
-                try {
-                    translator(last_exception);
-                } catch (...) {
-                    last_exception = std::current_exception();
-                    continue;
-                }
-                return nullptr;
-            }
-            PyErr_SetString(PyExc_SystemError, "Exception escaped from default exception translator!");
+               translator a chance to translate it to a Python exception */
+            translate_exception(&typeid(e));
+            return nullptr;
+        } catch (...) {
+            translate_exception(nullptr);
             return nullptr;
         }
 
-        if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
+        if (result.ptr() == PYBIND11_ERROR_RESULT) {
+            return nullptr;
+        } else if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
             if (overloads->is_operator)
                 return handle(Py_NotImplemented).inc_ref().ptr();
 
@@ -661,7 +863,7 @@ protected:
                 bool wrote_sig = false;
                 if (overloads->is_constructor) {
                     // For a constructor, rewrite `(self: Object, arg0, ...) -> NoneType` as `Object(arg0, ...)`
-                    std::string sig = it2->signature;
+                    std::string sig = signature(it2);
                     size_t start = sig.find('(') + 7; // skip "(self: "
                     if (start < sig.size()) {
                         // End at the , for the next argument
@@ -677,7 +879,7 @@ protected:
                         }
                     }
                 }
-                if (!wrote_sig) msg += it2->signature;
+                if (!wrote_sig) msg += signature(it2);
 
                 msg += "\n";
             }
@@ -708,7 +910,7 @@ protected:
         } else if (!result) {
             std::string msg = "Unable to convert function return value to a "
                               "Python type! The signature was\n\t";
-            msg += it->signature;
+            msg += signature(it);
             PyErr_SetString(PyExc_TypeError, msg.c_str());
             return nullptr;
         } else {
@@ -734,7 +936,9 @@ public:
         std::memset(def, 0, sizeof(PyModuleDef));
         def->m_name = name;
         def->m_doc = doc;
-        def->m_size = -1;
+        // Not -1: CPython would otherwise reuse a copy of the module dictionary of the main
+        // interpreter when the module is imported by a sub-interpreter, instead of initializing it
+        def->m_size = 0;
         Py_INCREF(def);
         m_ptr = PyModule_Create(def);
 #else
@@ -811,6 +1015,30 @@ inline dict globals() {
 }
 
 NAMESPACE_BEGIN(detail)
+/// Return a new reference to the module `name` if its initialization function already ran in the
+/// current interpreter (e.g. when it is imported again after being removed from `sys.modules`), or
+/// nullptr otherwise. Extension modules are initialized once per (sub-)interpreter, so that their
+/// types are registered in the internals of each interpreter importing them.
+inline PyObject *get_initialized_module(const char *name) {
+    auto &modules = get_internals().initialized_modules;
+    auto it = modules.find(name);
+    if (it == modules.end())
+        return nullptr;
+    Py_INCREF(it->second);
+    return it->second;
+}
+
+/// Record the result of a module initialization function and pass it through
+inline PyObject *add_initialized_module(const char *name, PyObject *m) {
+    if (m) {
+        auto &slot = get_internals().initialized_modules[name];
+        Py_XDECREF(slot);
+        slot = m;
+        Py_INCREF(m);
+    }
+    return m;
+}
+
 /// Generic support for creating new Python heap types
 class generic_type : public object {
     template <typename...> friend class class_;
@@ -882,7 +1110,16 @@ protected:
                 "include the pybind11::buffer_protocol() annotation!");
 
         tinfo->get_buffer = get_buffer;
+        tinfo->fill_buffer = nullptr;
         tinfo->get_buffer_data = get_buffer_data;
+        get_internals().buffer_types.clear();
+    }
+
+    void install_buffer_funcs(
+            bool (*fill_buffer)(PyObject *, void *, buffer_record &),
+            void *get_buffer_data) {
+        install_buffer_funcs((buffer_info *(*)(PyObject *, void *)) nullptr, get_buffer_data);
+        detail::get_type_info(&((PyHeapTypeObject *) m_ptr)->ht_type)->fill_buffer = fill_buffer;
     }
 
     void def_property_static_impl(const char *name,
@@ -900,6 +1137,23 @@ protected:
     }
 };
 
+/// Whether a member of `C` is at a fixed offset within `T`, i.e. `C` is `T` or a non-virtual base
+template <typename T, typename C, typename SFINAE = void> struct is_fixed_offset_member : std::false_type { };
+template <typename T, typename C> struct is_fixed_offset_member<T, C, void_t<decltype(
+    static_cast<T *>(std::declval<C *>()))>> : std::true_type { };
+
+/// Whether fields of type `T` can be accessed through a `pybind11_member` descriptor: arithmetic
+/// types, `bool`, and POD-like classes (standard layout, trivially destructible) bound with `class_`
+template <typename T> using is_native_member_type = bool_constant<
+    std::is_arithmetic<T>::value ||
+    (std::is_class<T>::value && std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value &&
+     std::is_base_of<type_caster_generic, make_caster<T>>::value)>;
+
+/// Whether a `def_buffer` callback fills in a `buffer_record` (rather than returning a `buffer_info`)
+template <typename Func, typename T, typename SFINAE = void> struct is_buffer_filler : std::false_type { };
+template <typename Func, typename T> struct is_buffer_filler<Func, T, void_t<decltype(
+    std::declval<Func &>()(std::declval<T &>(), std::declval<buffer_record &>()))>> : std::true_type { };
+
 /// Set the pointer to operator new if it exists. The cast is needed because it can be overloaded.
 template <typename T, typename = void_t<decltype(static_cast<void *(*)(size_t)>(T::operator new))>>
 void set_operator_new(type_record *r) { r->operator_new = &T::operator new; }
@@ -912,6 +1166,63 @@ void call_operator_delete(T *p) { T::operator delete(p); }
 
 inline void call_operator_delete(void *p) { ::operator delete(p); }
 
+/// Implements `__reduce_ex__` for `class_::def_pickle_buffer`.  With pickle protocol 5 (Python
+/// 3.8+), the data of a C-contiguous buffer is wrapped in a `pickle.PickleBuffer`, which allows it
+/// to be transferred out-of-band without being copied.
+PYBIND11_NOINLINE inline tuple pickle_buffer_reduce(handle self, int protocol) {
+    auto info = reinterpret_borrow<buffer>(self).request();
+    bool contiguous = true;
+    ssize_t expected = info.itemsize;
+    for (ssize_t i = info.ndim - 1; i >= 0; --i) {
+        if (info.shape[(size_t) i] != 1 && info.strides[(size_t) i] != expected)
+            contiguous = false;
+        expected *= info.shape[(size_t) i];
+    }
+
+    object data;
+    auto pickle = module::import("pickle");
+    if (protocol >= 5 && contiguous && hasattr(pickle, "PickleBuffer"))
+        data = pickle.attr("PickleBuffer")(self);
+    else
+        data = reinterpret_steal<object>(PyMemoryView_FromObject(self.ptr())).attr("tobytes")();
+
+    tuple shape(info.shape.size());
+    for (size_t i = 0; i < info.shape.size(); ++i)
+        shape[i] = int_(info.shape[i]);
+
+#if PY_MAJOR_VERSION >= 3
+    auto copyreg = module::import("copyreg");
+#else
+    auto copyreg = module::import("copy_reg");
+#endif
+    return pybind11::make_tuple(copyreg.attr("__newobj__"),
+                                pybind11::make_tuple(handle((PyObject *) Py_TYPE(self.ptr()))),
+                                pybind11::make_tuple(data, info.format, info.itemsize, shape));
+}
+
+/// Interprets a state tuple produced by `pickle_buffer_reduce` as a C-contiguous buffer.  `raw`
+/// holds on to the underlying data for as long as the returned buffer is used.
+PYBIND11_NOINLINE inline buffer_info pickle_buffer_info(tuple state, buffer_info &raw) {
+    if (state.size() != 4)
+        throw value_error("Invalid state!");
+    raw = state[0].cast<buffer>().request();
+    auto format = state[1].cast<std::string>();
+    auto itemsize = state[2].cast<ssize_t>();
+    auto shape_in = state[3].cast<tuple>();
+
+    std::vector<ssize_t> shape(shape_in.size()), strides(shape_in.size());
+    ssize_t stride = itemsize;
+    for (size_t i = shape.size(); i-- > 0; ) {
+        shape[i] = shape_in[i].cast<ssize_t>();
+        strides[i] = stride;
+        stride *= shape[i];
+    }
+    if (raw.size * raw.itemsize != stride)
+        throw value_error("Invalid state: buffer size does not match its shape!");
+    auto ndim = (ssize_t) shape.size();
+    return buffer_info(raw.ptr, itemsize, format, ndim, std::move(shape), std::move(strides));
+}
+
 NAMESPACE_END(detail)
 
 /// Given a pointer to a member function, cast it to its `Derived` version.
@@ -981,6 +1292,28 @@ public:
             auto &instances = get_internals().registered_types_cpp;
             instances[std::type_index(typeid(type_alias))] = instances[std::type_index(typeid(type))];
         }
+
+        def_pickle_trivial(bool_constant<any_of<std::is_same<pickle_trivial, Extra>...>::value>());
+    }
+
+    void def_pickle_trivial(std::false_type) { }
+
+    /// Pickles the object as a copy of its bytes (see `pickle_trivial`)
+    void def_pickle_trivial(std::true_type) {
+#if !defined(__GNUG__) || defined(__clang__) || __GNUC__ >= 5
+        static_assert(std::is_trivially_copyable<type>::value,
+                      "py::pickle_trivial() requires a trivially copyable type");
+#endif
+        def("__getstate__", [](const type &p) {
+            return bytes(reinterpret_cast<const char *>(&p), sizeof(type));
+        });
+        def("__setstate__", [](type &p, bytes state) {
+            char *buffer;
+            ssize_t length;
+            if (PYBIND11_BYTES_AS_STRING_AND_SIZE(state.ptr(), &buffer, &length) || length != (ssize_t) sizeof(type))
+                throw value_error("Invalid state!");
+            std::memcpy(reinterpret_cast<void *>(&p), buffer, sizeof(type));
+        });
     }
 
     template <typename Base, detail::enable_if_t<is_base<Base>::value, int> = 0>
@@ -1035,31 +1368,50 @@ public:
         return *this;
     }
 
+    /** \rst
+        Provides the buffer of instances, either by returning a `buffer_info` from ``func(self)``,
+        or (avoiding all heap allocations) by filling in the `buffer_record` passed to
+        ``func(self, record)``.
+    \endrst */
     template <typename Func> class_& def_buffer(Func &&func) {
-        struct capture { Func func; };
-        capture *ptr = new capture { std::forward<Func>(func) };
-        install_buffer_funcs([](PyObject *obj, void *ptr) -> buffer_info* {
-            detail::make_caster<type> caster;
-            if (!caster.load(obj, false))
-                return nullptr;
-            return new buffer_info(((capture *) ptr)->func(caster));
-        }, ptr);
-        return *this;
+        return def_buffer_impl(std::forward<Func>(func), detail::is_buffer_filler<Func, type>{});
     }
 
     template <typename Return, typename Class, typename... Args>
     class_ &def_buffer(Return (Class::*func)(Args...)) {
-        return def_buffer([func] (type &obj) { return (obj.*func)(); });
+        return def_buffer([func] (type &obj, Args... args) { return (obj.*func)(std::forward<Args>(args)...); });
     }
 
     template <typename Return, typename Class, typename... Args>
     class_ &def_buffer(Return (Class::*func)(Args...) const) {
-        return def_buffer([func] (const type &obj) { return (obj.*func)(); });
+        return def_buffer([func] (const type &obj, Args... args) { return (obj.*func)(std::forward<Args>(args)...); });
+    }
+
+    /** \rst
+        Adds pickling support for a class with the buffer protocol.  The buffer's data is pickled
+        together with its format and shape; with pickle protocol 5, it is passed as an
+        out-of-band ``pickle.PickleBuffer`` instead of being copied into the pickle stream.
+
+        When unpickling, ``func`` is called with a C-contiguous :class:`buffer_info` describing the
+        data and must return a new instance.  The data is only valid for the duration of the call.
+    \endrst */
+    template <typename Func> class_ &def_pickle_buffer(Func &&func) {
+        def("__reduce_ex__", [](handle self, int protocol) {
+            return detail::pickle_buffer_reduce(self, protocol);
+        });
+        def("__setstate__", [func](type &p, tuple state) {
+            buffer_info raw;
+            auto info = detail::pickle_buffer_info(state, raw);
+            new (&p) type(func(info));
+        });
+        return *this;
     }
 
     template <typename C, typename D, typename... Extra>
     class_ &def_readwrite(const char *name, D C::*pm, const Extra&... extra) {
         static_assert(std::is_base_of<C, type>::value, "def_readwrite() requires a class member (or base class member)");
+        if (def_member(name, pm, true, is_native_member<C, D, Extra...>(), extra...))
+            return *this;
         cpp_function fget([pm](const type &c) -> const D &{ return c.*pm; }, is_method(*this)),
                      fset([pm](type &c, const D &value) { c.*pm = value; }, is_method(*this));
         def_property(name, fget, fset, return_value_policy::reference_internal, extra...);
@@ -1069,6 +1421,8 @@ public:
     template <typename C, typename D, typename... Extra>
     class_ &def_readonly(const char *name, const D C::*pm, const Extra& ...extra) {
         static_assert(std::is_base_of<C, type>::value, "def_readonly() requires a class member (or base class member)");
+        if (def_member(name, const_cast<D C::*>(pm), false, is_native_member<C, D, Extra...>(), extra...))
+            return *this;
         cpp_function fget([pm](const type &c) -> const D &{ return c.*pm; }, is_method(*this));
         def_property_readonly(name, fget, return_value_policy::reference_internal, extra...);
         return *this;
@@ -1160,6 +1514,124 @@ public:
     }
 
 private:
+    template <typename Func> class_ &def_buffer_impl(Func &&func, std::false_type) {
+        struct capture { Func func; };
+        capture *ptr = new capture { std::forward<Func>(func) };
+        install_buffer_funcs([](PyObject *obj, void *ptr) -> buffer_info* {
+            detail::make_caster<type> caster;
+            if (!caster.load(obj, false))
+                return nullptr;
+            return new buffer_info(((capture *) ptr)->func(caster));
+        }, ptr);
+        return *this;
+    }
+
+    template <typename Func> class_ &def_buffer_impl(Func &&func, std::true_type) {
+        struct capture { typename std::decay<Func>::type func; };
+        capture *ptr = new capture { std::forward<Func>(func) };
+        install_buffer_funcs([](PyObject *obj, void *ptr, buffer_record &record) -> bool {
+            try {
+                detail::make_caster<type> caster;
+                if (!caster.load(obj, false))
+                    return false;
+                ((capture *) ptr)->func(detail::cast_op<type &>(caster), record);
+                return true;
+            } catch (error_already_set &e) {
+                e.restore();
+            } catch (const std::exception &e) {
+                detail::translate_exception(&typeid(e));
+            } catch (...) {
+                detail::translate_exception(nullptr);
+            }
+            return false;
+        }, ptr);
+        return *this;
+    }
+
+    /// Fields of arithmetic, `bool` and registered POD type in `type` or a non-virtual base class
+    /// are bound with a native `pybind11_member` descriptor, as long as the only extras are docstrings
+    template <typename C, typename D, typename... Extra> using is_native_member = detail::bool_constant<
+        detail::is_fixed_offset_member<type, C>::value && detail::is_native_member_type<D>::value &&
+        detail::all_of<std::is_convertible<const Extra &, const char *>...>::value>;
+
+    static const char *member_doc() { return nullptr; }
+    template <typename... Docs> static const char *member_doc(const char *doc, const Docs &...docs) {
+        const char *last = member_doc(docs...);
+        return last ? last : doc;
+    }
+
+    template <typename C, typename D, typename... Extra>
+    bool def_member(const char *, D C::*, bool, std::false_type, const Extra &...) { return false; }
+
+    /// Binds `pm` with a `pybind11_member` descriptor; returns false if it isn't available (on PyPy)
+    template <typename C, typename D, typename... Extra>
+    bool def_member(const char *name, D C::*pm, bool writable, std::true_type, const Extra &...extra) {
+        PyTypeObject *descr_type = detail::get_internals().member_descriptor_type;
+        if (!descr_type)
+            return false;
+
+        struct capture { D C::*pm; };
+        static_assert(sizeof(capture) <= sizeof(detail::member_record::data), "Member pointer does not fit");
+
+        std::unique_ptr<detail::member_record> rec(new detail::member_record());
+        rec->name = strdup(name);
+        const char *doc = member_doc(extra...);
+        if (doc && pybind11::options::show_user_defined_docstrings())
+            rec->doc = strdup(doc);
+        rec->tinfo = detail::get_type_info(typeid(type));
+        new ((capture *) &rec->data) capture { pm };
+
+        rec->resolve = [](void *value, const detail::member_record &rec) -> ssize_t {
+            C *self = static_cast<type *>(value);
+            return reinterpret_cast<char *>(&(self->*((const capture *) &rec.data)->pm)) - static_cast<char *>(value);
+        };
+        rec->get = [](void *field, PyObject *self) -> PyObject * {
+            try {
+                return detail::make_caster<D>::cast(*static_cast<const D *>(field),
+                                                    return_value_policy::reference_internal, self).ptr();
+            } catch (error_already_set &e) {
+                e.restore();
+            } catch (const std::exception &e) {
+                detail::translate_exception(&typeid(e));
+            } catch (...) {
+                detail::translate_exception(nullptr);
+            }
+            return nullptr;
+        };
+        if (writable) {
+            rec->set = [](void *field, PyObject *value) -> bool {
+                try {
+                    detail::loader_life_support life_support;
+                    detail::make_caster<D> conv;
+                    if (conv.load(value, true)) {
+                        *static_cast<D *>(field) = detail::cast_op<const D &>(conv);
+                        return true;
+                    }
+                } catch (reference_cast_error &) {
+                } catch (error_already_set &e) {
+                    e.restore();
+                    return false;
+                } catch (const std::exception &e) {
+                    detail::translate_exception(&typeid(e));
+                    return false;
+                } catch (...) {
+                    detail::translate_exception(nullptr);
+                    return false;
+                }
+                PyErr_Format(PyExc_TypeError, "Unable to convert '%s' object to C++ type '%s'",
+                             Py_TYPE(value)->tp_name, type_id<D>().c_str());
+                return false;
+            };
+        }
+
+        auto descr = reinterpret_steal<object>(descr_type->tp_alloc(descr_type, 0));
+        if (!descr)
+            throw error_already_set();
+        reinterpret_cast<detail::member_descriptor *>(descr.ptr())->rec = rec.release();
+        attr(name) = descr;
+        return true;
+    }
+
     /// Initialize holder object, variant 1: object derives from enable_shared_from_this
     template <typename T>
     static void init_holder_helper(detail::instance *inst, detail::value_and_holder &v_h,
@@ -1222,6 +1694,157 @@ private:
     }
 };
 
+NAMESPACE_BEGIN(detail)
+/// Native type slots for `enum_`: comparisons, hashing, repr() and arithmetic don't have to go
+/// through `cpp_function::dispatcher`.
+template <typename Type, bool Arithmetic> struct enum_slots {
+    using Scalar = typename std::underlying_type<Type>::type;
+    static constexpr bool is_convertible = std::is_convertible<Type, Scalar>::value;
+
+    static void init(PyHeapTypeObject *heap_type) {
+        heap_type->ht_type.tp_richcompare = richcompare;
+        heap_type->ht_type.tp_hash = hash;
+        heap_type->ht_type.tp_repr = repr;
+        heap_type->as_number.nb_int = to_int;
+#if PY_MAJOR_VERSION < 3
+        heap_type->as_number.nb_long = to_int;
+#endif
+        if (Arithmetic && is_convertible) {
+            heap_type->as_number.nb_invert = invert;
+            heap_type->as_number.nb_and = bitwise_and;
+            heap_type->as_number.nb_or = bitwise_or;
+            heap_type->as_number.nb_xor = bitwise_xor;
+        }
+    }
+
+    /// Whether `obj` is an instance of a Python type created by `enum_` for `Type`. Such types are
+    /// recognized by their slots rather than through a cached type object, since each interpreter
+    /// has its own.
+    static bool is_instance(PyObject *obj) {
+        for (auto type = Py_TYPE(obj); type; type = type->tp_base) {
+            if (type->tp_hash == hash)
+                return true;
+        }
+        return false;
+    }
+
+    /// Extracts the value of an instance of the enum type
+    static bool value_of(PyObject *obj, Scalar &value) {
+        if (!is_instance(obj))
+            return false;
+        auto ptr = reinterpret_cast<instance *>(obj)->get_value_and_holder().value_ptr();
+        if (!ptr)
+            return false;
+        value = static_cast<Scalar>(*reinterpret_cast<Type *>(ptr));
+        return true;
+    }
+
+    /// Extracts the value of an instance of the enum type or (if permitted) a Python integer
+    static bool operand(PyObject *obj, Scalar &value) {
+        if (value_of(obj, value))
+            return true;
+        make_caster<Scalar> conv;
+        if (!is_convertible || !conv.load(obj, true))
+            return false;
+        value = cast_op<Scalar>(conv);
+        return true;
+    }
+
+    template <typename T> static PyObject *to_python(T value) {
+        return make_caster<T>::cast(value, return_value_policy::copy, nullptr).ptr();
+    }
+
+    static PyObject *richcompare(PyObject *self, PyObject *other, int op) {
+        bool ordering = op != Py_EQ && op != Py_NE;
+        if (ordering && !Arithmetic) {
+            Py_INCREF(Py_NotImplemented);
+            return Py_NotImplemented;
+        }
+        Scalar a, b;
+        if (!value_of(self, a)) {
+            Py_INCREF(Py_NotImplemented);
+            return Py_NotImplemented;
+        }
+        bool result;
+        if (other == Py_None) {
+            // An enum never compares equal (or ordered) to None
+            result = op == Py_NE;
+        } else if (operand(other, b)) {
+            switch (op) {
+                case Py_EQ: result = a == b; break;
+                case Py_NE: result = a != b; break;
+                case Py_LT: result = a < b; break;
+                case Py_LE: result = a <= b; break;
+                case Py_GT: result = a > b; break;
+                default:    result = a >= b; break;
+            }
+        } else {
+            PyErr_Format(PyExc_TypeError, "unsupported comparison between instances of '%s' and '%s'",
+                         Py_TYPE(self)->tp_name, Py_TYPE(other)->tp_name);
+            return nullptr;
+        }
+        return handle(result ? Py_True : Py_False).inc_ref().ptr();
+    }
+
+    static auto hash(PyObject *self) -> decltype(PyObject_Hash(self)) {
+        Scalar value;
+        if (!value_of(self, value)) {
+            PyErr_SetString(PyExc_TypeError, "unhashable enum instance");
+            return -1;
+        }
+        auto h = reinterpret_steal<object>(to_python(value));
+        return h ? PyObject_Hash(h.ptr()) : -1;
+    }
+
+    static PyObject *repr(PyObject *self) {
+        Scalar value;
+        auto tinfo = get_type_info(typeid(Type));
+        if (tinfo && value_of(self, value)) {
+            auto it = tinfo->enum_members.find(static_cast<unsigned long long>(value));
+            if (it != tinfo->enum_members.end())
+                return handle(it->second.repr).inc_ref().ptr();
+        }
+        try {
+            return str("{}.???").format(handle((PyObject *) Py_TYPE(self)).attr("__name__")).release().ptr();
+        } catch (error_already_set &e) {
+            e.restore();
+            return nullptr;
+        }
+    }
+
+    static PyObject *to_int(PyObject *self) {
+        Scalar value;
+        if (!value_of(self, value)) {
+            PyErr_SetString(PyExc_TypeError, "uninitialized enum instance");
+            return nullptr;
+        }
+        return to_python(value);
+    }
+
+    static PyObject *invert(PyObject *self) {
+        Scalar value;
+        if (!value_of(self, value)) {
+            Py_INCREF(Py_NotImplemented);
+            return Py_NotImplemented;
+        }
+        return to_python(~value);
+    }
+
+    template <typename Op> static PyObject *binary(PyObject *a, PyObject *b, Op op) {
+        Scalar x, y;
+        if (!operand(a, x) || !operand(b, y)) {
+            Py_INCREF(Py_NotImplemented);
+            return Py_NotImplemented;
+        }
+        return to_python(op(x, y));
+    }
+
+    static PyObject *bitwise_and(PyObject *a, PyObject *b) { return binary(a, b, [](Scalar x, Scalar y) { return x & y; }); }
+    static PyObject *bitwise_or(PyObject *a, PyObject *b)  { return binary(a, b, [](Scalar x, Scalar y) { return x | y; }); }
+    static PyObject *bitwise_xor(PyObject *a, PyObject *b) { return binary(a, b, [](Scalar x, Scalar y) { return x ^ y; }); }
+};
+NAMESPACE_END(detail)
+
 /// Binds C++ enumerations and enumeration classes to Python
 template <typename Type> class enum_ : public class_<Type> {
 public:
@@ -1231,64 +1854,19 @@ public:
 
     template <typename... Extra>
     enum_(const handle &scope, const char *name, const Extra&... extra)
-      : class_<Type>(scope, name, extra...), m_entries(), m_parent(scope) {
-
-        constexpr bool is_arithmetic = detail::any_of<std::is_same<arithmetic, Extra>...>::value;
-
+      : class_<Type>(scope, name, detail::type_slots{&slots<Extra...>::init}, extra...),
+        m_entries(), m_parent(scope) {
         auto m_entries_ptr = m_entries.inc_ref().ptr();
-        def("__repr__", [name, m_entries_ptr](Type value) -> pybind11::str {
-            for (const auto &kv : reinterpret_borrow<dict>(m_entries_ptr)) {
-                if (pybind11::cast<Type>(kv.second) == value)
-                    return pybind11::str("{}.{}").format(name, kv.first);
-            }
-            return pybind11::str("{}.???").format(name);
-        });
         def_property_readonly_static("__members__", [m_entries_ptr](object /* self */) {
             dict m;
             for (const auto &kv : reinterpret_borrow<dict>(m_entries_ptr))
                 m[kv.first] = kv.second;
             return m;
         }, return_value_policy::copy);
-        def("__init__", [](Type& value, Scalar i) { value = (Type)i; });
-        def("__int__", [](Type value) { return (Scalar) value; });
-        #if PY_MAJOR_VERSION < 3
-            def("__long__", [](Type value) { return (Scalar) value; });
-        #endif
-        def("__eq__", [](const Type &value, Type *value2) { return value2 && value == *value2; });
-        def("__ne__", [](const Type &value, Type *value2) { return !value2 || value != *value2; });
-        if (is_arithmetic) {
-            def("__lt__", [](const Type &value, Type *value2) { return value2 && value < *value2; });
-            def("__gt__", [](const Type &value, Type *value2) { return value2 && value > *value2; });
-            def("__le__", [](const Type &value, Type *value2) { return value2 && value <= *value2; });
-            def("__ge__", [](const Type &value, Type *value2) { return value2 && value >= *value2; });
-        }
-        if (std::is_convertible<Type, Scalar>::value) {
-            // Don't provide comparison with the underlying type if the enum isn't convertible,
-            // i.e. if Type is a scoped enum, mirroring the C++ behaviour.  (NB: we explicitly
-            // convert Type to Scalar below anyway because this needs to compile).
-            def("__eq__", [](const Type &value, Scalar value2) { return (Scalar) value == value2; });
-            def("__ne__", [](const Type &value, Scalar value2) { return (Scalar) value != value2; });
-            if (is_arithmetic) {
-                def("__lt__", [](const Type &value, Scalar value2) { return (Scalar) value < value2; });
-                def("__gt__", [](const Type &value, Scalar value2) { return (Scalar) value > value2; });
-                def("__le__", [](const Type &value, Scalar value2) { return (Scalar) value <= value2; });
-                def("__ge__", [](const Type &value, Scalar value2) { return (Scalar) value >= value2; });
-                def("__invert__", [](const Type &value) { return ~((Scalar) value); });
-                def("__and__", [](const Type &value, Scalar value2) { return (Scalar) value & value2; });
-                def("__or__", [](const Type &value, Scalar value2) { return (Scalar) value | value2; });
-                def("__xor__", [](const Type &value, Scalar value2) { return (Scalar) value ^ value2; });
-                def("__rand__", [](const Type &value, Scalar value2) { return (Scalar) value & value2; });
-                def("__ror__", [](const Type &value, Scalar value2) { return (Scalar) value | value2; });
-                def("__rxor__", [](const Type &value, Scalar value2) { return (Scalar) value ^ value2; });
-                def("__and__", [](const Type &value, const Type &value2) { return (Scalar) value & (Scalar) value2; });
-                def("__or__", [](const Type &value, const Type &value2) { return (Scalar) value | (Scalar) value2; });
-                def("__xor__", [](const Type &value, const Type &value2) { return (Scalar) value ^ (Scalar) value2; });
-            }
-        }
-        def("__hash__", [](const Type &value) { return (Scalar) value; });
+        def("__init__", [](handle self, Scalar i) { initialize(self, (Type) i); });
         // Pickling and unpickling -- needed for use with the 'multiprocessing' module
         def("__getstate__", [](const Type &value) { return pybind11::make_tuple((Scalar) value); });
-        def("__setstate__", [](Type &p, tuple t) { new (&p) Type((Type) t[0].cast<Scalar>()); });
+        def("__setstate__", [](handle self, tuple t) { initialize(self, (Type) t[0].cast<Scalar>()); });
     }
 
     /// Export enumeration entries into the parent scope
@@ -1303,10 +1881,29 @@ public:
         auto v = pybind11::cast(value, return_value_policy::copy);
         this->attr(name) = v;
         m_entries[pybind11::str(name)] = v;
+        // The first entry with a given value is the one returned when casting that value
+        auto repr = pybind11::str("{}.{}").format(this->attr("__name__"), name);
+        auto &members = detail::get_type_info(typeid(Type))->enum_members;
+        if (members.emplace(static_cast<unsigned long long>(value),
+                            detail::enum_member{v.ptr(), repr.ptr()}).second)
+            repr.release();
         return *this;
     }
 
 private:
+    /// Sets the value of `self`, unless it is one of the member objects shared by all casts
+    static void initialize(handle self, Type value) {
+        for (const auto &member : detail::get_type_info(typeid(Type))->enum_members) {
+            if (member.second.value == self.ptr())
+                throw type_error("cannot re-initialize the enum member " +
+                                 (std::string) reinterpret_borrow<str>(member.second.repr));
+        }
+        new (&self.cast<Type &>()) Type(value);
+    }
+
+    template <typename... Extra>
+    using slots = detail::enum_slots<Type, detail::any_of<std::is_same<arithmetic, Extra>...>::value>;
+
     dict m_entries;
     handle m_parent;
 };
@@ -1397,7 +1994,9 @@ inline std::pair<decltype(internals::registered_types_py)::iterator, bool> all_t
         // New cache entry created; set up a weak reference to automatically remove it if the type
         // gets destroyed:
         weakref((PyObject *) type, cpp_function([type](handle wr) {
-            get_internals().registered_types_py.erase(type);
+            auto &internals = get_internals();
+            internals.registered_types_py.erase(type);
+            internals.buffer_types.erase(type);
             wr.dec_ref();
         })).release();
     }
@@ -1429,14 +2028,14 @@ iterator make_iterator(Iterator first, Sentinel last, Extra &&... extra) {
     if (!detail::get_type_info(typeid(state), false)) {
         class_<state>(handle(), "iterator")
             .def("__iter__", [](state &s) -> state& { return s; })
-            .def("__next__", [](state &s) -> ValueType {
+            .def("__next__", [](state &s) -> value_or_error<ValueType> {
                 if (!s.first_or_done)
                     ++s.it;
                 else
                     s.first_or_done = false;
                 if (s.it == s.end) {
                     s.first_or_done = true;
-                    throw stop_iteration();
+                    return error_result(PyExc_StopIteration);
                 }
                 return *s.it;
             }, std::forward<Extra>(extra)..., Policy);
@@ -1458,14 +2057,14 @@ iterator make_key_iterator(Iterator first, Sentinel last, Extra &&... extra) {
     if (!detail::get_type_info(typeid(state), false)) {
         class_<state>(handle(), "iterator")
             .def("__iter__", [](state &s) -> state& { return s; })
-            .def("__next__", [](state &s) -> KeyType {
+            .def("__next__", [](state &s) -> value_or_error<KeyType> {
                 if (!s.first_or_done)
                     ++s.it;
                 else
                     s.first_or_done = false;
                 if (s.it == s.end) {
                     s.first_or_done = true;
-                    throw stop_iteration();
+                    return error_result(PyExc_StopIteration);
                 }
                 return (*s.it).first;
             }, std::forward<Extra>(extra)..., Policy);
@@ -1508,8 +2107,10 @@ template <typename InputType, typename OutputType> void implicitly_convertible()
 
 template <typename ExceptionTranslator>
 void register_exception_translator(ExceptionTranslator&& translator) {
-    detail::get_internals().registered_exception_translators.push_front(
+    auto &internals = detail::get_internals();
+    internals.registered_exception_translators.push_front(
         std::forward<ExceptionTranslator>(translator));
+    ++internals.generic_exception_translator_count;
 }
 
 /**
@@ -1548,16 +2149,22 @@ template <typename CppException>
 exception<CppException> &register_exception(handle scope,
                                             const char *name,
                                             PyObject *base = PyExc_Exception) {
-    static exception<CppException> ex(scope, name, base);
-    register_exception_translator([](std::exception_ptr p) {
+    // Every interpreter gets its own exception type (see `subinterpreter`). Like the types
+    // themselves, the objects are never freed: they may be used until the interpreter is gone.
+    auto &registered = detail::get_internals().registered_exceptions[typeid(CppException)];
+    if (!registered)
+        registered = new exception<CppException>(scope, name, base);
+    detail::register_typed_exception_translator([](std::exception_ptr p) {
         if (!p) return;
         try {
             std::rethrow_exception(p);
         } catch (const CppException &e) {
-            ex(e.what());
+            auto ex = static_cast<exception<CppException> *>(
+                detail::get_internals().registered_exceptions[typeid(CppException)]);
+            (*ex)(e.what());
         }
     });
-    return ex;
+    return *static_cast<exception<CppException> *>(registered);
 }
 
 NAMESPACE_BEGIN(detail)
@@ -1630,7 +2237,12 @@ public:
         tstate = (PyThreadState *) PyThread_get_key_value(internals.tstate);
 
         if (!tstate) {
-            tstate = PyThreadState_New(internals.istate);
+            // Threads which have not activated a sub-interpreter run in the main interpreter
+            #if PY_VERSION_HEX >= 0x03070000
+                tstate = PyThreadState_New(PyInterpreterState_Main());
+            #else
+                tstate = PyThreadState_New(internals.istate);
+            #endif
             #if !defined(NDEBUG)
                 if (!tstate)
                     pybind11_fail("scoped_acquire: could not create thread state!");
@@ -1765,7 +2377,8 @@ inline function get_type_overload(const void *this_ptr, const detail::type_info
     if (cache.find(key) != cache.end())
         return function();
 
-    function overload = getattr(self, name, function());
+    handle interned_name = interned(name).ptr();
+    function overload = getattr(self, interned_name, function());
     if (overload.is_cpp_function()) {
         cache.insert(key);
         return function();
@@ -1775,8 +2388,8 @@ inline function get_type_overload(const void *this_ptr, const detail::type_info
        Unfortunately this doesn't work on PyPy. */
 #if !defined(PYPY_VERSION)
     PyFrameObject *frame = PyThreadState_Get()->frame;
-    if (frame && (std::string) str(frame->f_code->co_name) == name &&
-        frame->f_code->co_argcount > 0) {
+    if (frame && frame->f_code->co_argcount > 0 &&
+        PyObject_RichCompareBool(frame->f_code->co_name, interned_name.ptr(), Py_EQ) == 1) {
         PyFrame_FastToLocals(frame);
         PyObject *self_caller = PyDict_GetItem(
             frame->f_locals, PyTuple_GET_ITEM(frame->f_code->co_varnames, 0));
@@ -19,6 +19,7 @@ NAMESPACE_BEGIN(pybind11)
 /* A few forward declarations */
 class handle; class object;
 class str; class iterator;
+class interned;
 struct arg; struct arg_v;
 
 NAMESPACE_BEGIN(detail)
@@ -72,6 +73,8 @@ public:
     item_accessor operator[](handle key) const;
     /// See above (the only difference is that they key is provided as a string literal)
     item_accessor operator[](const char *key) const;
+    /// See above (the key is an interned name, which avoids creating a new Python string)
+    item_accessor operator[](const interned &key) const;
 
     /** \rst
         Return an internal functor to access the object's attributes. Casting the
@@ -82,6 +85,8 @@ public:
     obj_attr_accessor attr(handle key) const;
     /// See above (the only difference is that they key is provided as a string literal)
     str_attr_accessor attr(const char *key) const;
+    /// See above (the key is an interned name, which avoids creating a new Python string)
+    obj_attr_accessor attr(const interned &key) const;
 
     /** \rst
         Matches * unpacking in Python, e.g. to unpack arguments out of a ``tuple``
@@ -307,6 +312,66 @@ inline bool isinstance(handle obj, handle type) {
     return result != 0;
 }
 
+/** \rst
+    A name (typically of an attribute) which is converted to an interned Python string only once
+    per interpreter and then reused. `getattr`, `hasattr`, `setattr`, ``obj.attr()`` and
+    ``obj[]`` accept it in place of a ``const char *``, saving the creation (and hashing) of a
+    temporary string on every call. Each instance also remembers the string it last returned, so
+    that a long-lived (e.g. ``static``) one skips the registry lookup as well. The given string
+    must outlive the `interned` instance.
+
+    .. code-block:: cpp
+
+        static const py::interned evaluate("evaluate");
+        for (auto &model : models)
+            total += model.attr(evaluate)(x).cast<double>();
+
+        // or, using the literal:
+        using namespace py::literals;
+        model.attr("evaluate"_id)(x);
+\endrst */
+class interned {
+public:
+    constexpr explicit interned(const char *name) : m_name(name) { }
+
+    const char *name() const { return m_name; }
+
+    /// The interned Python string (a borrowed reference owned by the current interpreter)
+    handle ptr() const {
+        auto &internals = detail::get_internals();
+        // The string of the last interpreter is kept until another one is active or a
+        // `subinterpreter` is destroyed (whose internals' address could then be reused)
+        if (m_owner == &internals && m_generation == internals.interpreters->generation)
+            return m_value;
+        auto &names = internals.interned_names;
+        auto it = names.find(m_name);
+        if (it == names.end()) {
+#if PY_MAJOR_VERSION >= 3
+            PyObject *value = PyUnicode_InternFromString(m_name);
+            const char *key = value ? PyUnicode_AsUTF8(value) : nullptr;
+#else
+            PyObject *value = PyString_InternFromString(m_name);
+            const char *key = value ? PyString_AS_STRING(value) : nullptr;
+#endif
+            if (!key) {
+                Py_XDECREF(value);
+                throw error_already_set();
+            }
+            it = names.emplace(key, value).first;
+        }
+        m_owner = &internals;
+        m_generation = internals.interpreters->generation;
+        m_value = it->second;
+        return m_value;
+    }
+
+private:
+    const char *m_name;
+    mutable const detail::internals *m_owner = nullptr;
+    mutable size_t m_generation = 0;
+    mutable PyObject *m_value = nullptr;
+};
+
 /// \addtogroup python_builtins
 /// @{
 inline bool hasattr(handle obj, handle name) {
@@ -354,6 +419,16 @@ inline void setattr(handle obj, handle name, handle value) {
 inline void setattr(handle obj, const char *name, handle value) {
     if (PyObject_SetAttrString(obj.ptr(), name, value.ptr()) != 0) { throw error_already_set(); }
 }
+
+inline bool hasattr(handle obj, const interned &name) { return hasattr(obj, name.ptr()); }
+
+inline object getattr(handle obj, const interned &name) { return getattr(obj, name.ptr()); }
+
+inline object getattr(handle obj, const interned &name, handle default_) {
+    return getattr(obj, name.ptr(), default_);
+}
+
+inline void setattr(handle obj, const interned &name, handle value) { setattr(obj, name.ptr(), value); }
 /// @} python_builtins
 
 NAMESPACE_BEGIN(detail)
@@ -847,6 +922,11 @@ inline namespace literals {
     String literal version of `str`
  \endrst */
 inline str operator"" _s(const char *s, size_t size) { return {s, size}; }
+
+/** \rst
+    String literal version of `interned`
+ \endrst */
+constexpr interned operator"" _id(const char *s, size_t) { return interned(s); }
 }
 
 /// \addtogroup pytypes
@@ -1164,7 +1244,7 @@ public:
     PYBIND11_OBJECT_DEFAULT(function, object, PyCallable_Check)
     handle cpp_function() const {
         handle fun = detail::get_function(m_ptr);
-        if (fun && PyCFunction_Check(fun.ptr()))
+        if (fun && PyObject_TypeCheck(fun.ptr(), &PyCFunction_Type))
             return fun;
         return handle();
     }
@@ -1256,9 +1336,15 @@ template <typename D> item_accessor object_api<D>::operator[](handle key) const
 template <typename D> item_accessor object_api<D>::operator[](const char *key) const {
     return {derived(), pybind11::str(key)};
 }
+template <typename D> item_accessor object_api<D>::operator[](const interned &key) const {
+    return {derived(), reinterpret_borrow<object>(key.ptr())};
+}
 template <typename D> obj_attr_accessor object_api<D>::attr(handle key) const {
     return {derived(), reinterpret_borrow<object>(key)};
 }
+template <typename D> obj_attr_accessor object_api<D>::attr(const interned &key) const {
+    return {derived(), reinterpret_borrow<object>(key.ptr())};
+}
 template <typename D> str_attr_accessor object_api<D>::attr(const char *key) const {
     return {derived(), key};
 }
@@ -17,6 +17,7 @@
 #include <iostream>
 #include <list>
 #include <valarray>
+#include <bitset>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -94,15 +95,73 @@ template <typename Type, typename Key> struct set_caster {
     PYBIND11_TYPE_CASTER(type, _("Set[") + key_conv::name() + _("]"));
 };
 
+/// Creates an empty dict with room for `size` items (avoiding repeated resizes while filling it)
+inline dict presized_dict(size_t size) {
+#if !defined(PYPY_VERSION)
+    auto result = reinterpret_steal<dict>(_PyDict_NewPresized((ssize_t) size));
+    if (!result)
+        throw error_already_set();
+    return result;
+#else
+    (void) size;
+    return dict();
+#endif
+}
+
+/// While alive, `std::string` dict keys converted by `map_caster` are looked up in a shared table
+/// so that equal keys (e.g. the column names of a list of records) become one Python string
+/// object. Nested scopes reuse the outermost table.
+class map_key_interning {
+public:
+    map_key_interning() : previous(active()) {
+        if (!previous)
+            active() = this;
+    }
+    ~map_key_interning() {
+        if (!previous)
+            active() = nullptr;
+    }
+    map_key_interning(const map_key_interning &) = delete;
+    map_key_interning &operator=(const map_key_interning &) = delete;
+
+    /// Returns a new reference to the string `key`, interned in the active scope (if any)
+    static handle cast(const std::string &key, return_value_policy policy, handle parent) {
+        auto scope = active();
+        if (!scope)
+            return make_caster<std::string>::cast(key, policy, parent);
+        auto it = scope->keys.find(key);
+        if (it == scope->keys.end()) {
+            auto str = reinterpret_steal<object>(make_caster<std::string>::cast(key, policy, parent));
+            if (!str)
+                return handle();
+            it = scope->keys.emplace(key, std::move(str)).first;
+        }
+        return it->second.inc_ref();
+    }
+
+private:
+    static map_key_interning *&active() {
+        static map_key_interning *scope = nullptr;
+        return scope;
+    }
+
+    map_key_interning *previous;
+    std::unordered_map<std::string, object> keys;
+};
+
 template <typename Type, typename Key, typename Value> struct map_caster {
     using key_conv   = make_caster<Key>;
     using value_conv = make_caster<Value>;
 
+    /// Whether sequences of these maps should convert their keys in a `map_key_interning` scope
+    static constexpr bool interned_keys = std::is_same<Key, std::string>::value;
+
     bool load(handle src, bool convert) {
         if (!isinstance<dict>(src))
             return false;
         auto d = reinterpret_borrow<dict>(src);
         value.clear();
+        reserve_maybe(d, &value);
         for (auto it : d) {
             key_conv kconv;
             value_conv vconv;
@@ -114,15 +173,32 @@ template <typename Type, typename Key, typename Value> struct map_caster {
         return true;
     }
 
+private:
+    template <typename T = Type,
+              enable_if_t<std::is_same<decltype(std::declval<T>().reserve(0)), void>::value, int> = 0>
+    void reserve_maybe(dict d, Type *) { value.reserve(d.size()); }
+    void reserve_maybe(dict, void *) { }
+
+    template <typename K, enable_if_t<std::is_same<intrinsic_t<K>, std::string>::value, int> = 0>
+    static handle cast_key(K &&key, return_value_policy policy, handle parent) {
+        return map_key_interning::cast(key, policy, parent);
+    }
+    template <typename K, enable_if_t<!std::is_same<intrinsic_t<K>, std::string>::value, int> = 0>
+    static handle cast_key(K &&key, return_value_policy policy, handle parent) {
+        return key_conv::cast(std::forward<K>(key), policy, parent);
+    }
+
+public:
     template <typename T>
     static handle cast(T &&src, return_value_policy policy, handle parent) {
-        dict d;
+        auto d = presized_dict(src.size());
         for (auto &kv: src) {
-            auto key = reinterpret_steal<object>(key_conv::cast(forward_like<T>(kv.first), policy, parent));
+            auto key = reinterpret_steal<object>(cast_key(forward_like<T>(kv.first), policy, parent));
             auto value = reinterpret_steal<object>(value_conv::cast(forward_like<T>(kv.second), policy, parent));
             if (!key || !value)
                 return handle();
-            d[key] = value;
+            if (PyDict_SetItem(d.ptr(), key.ptr(), value.ptr()) != 0)
+                throw error_already_set();
         }
         return d.release();
     }
@@ -130,6 +206,14 @@ template <typename Type, typename Key, typename Value> struct map_caster {
     PYBIND11_TYPE_CASTER(Type, _("Dict[") + key_conv::name() + _(", ") + value_conv::name() + _("]"));
 };
 
+/// Whether converting a sequence of `T` should happen in a `map_key_interning` scope
+template <typename T, typename SFINAE = void> struct interns_map_keys : std::false_type { };
+template <typename T> struct interns_map_keys<T, enable_if_t<make_caster<T>::interned_keys>> : std::true_type { };
+
+/// Opens a `map_key_interning` scope only if `Value` is a map with string keys
+template <typename Value, bool Interning = interns_map_keys<Value>::value> struct sequence_key_interning { };
+template <typename Value> struct sequence_key_interning<Value, true> { map_key_interning scope; };
+
 template <typename Type, typename Value> struct list_caster {
     using value_conv = make_caster<Value>;
 
@@ -159,6 +243,7 @@ public:
     static handle cast(T &&src, return_value_policy policy, handle parent) {
         list l(src.size());
         size_t index = 0;
+        sequence_key_interning<Value> interning; (void) interning;
         for (auto &value: src) {
             auto value_ = reinterpret_steal<object>(value_conv::cast(forward_like<T>(value), policy, parent));
             if (!value_)
@@ -213,6 +298,7 @@ public:
     static handle cast(T &&src, return_value_policy policy, handle parent) {
         list l(src.size());
         size_t index = 0;
+        sequence_key_interning<Value> interning; (void) interning;
         for (auto &value: src) {
             auto value_ = reinterpret_steal<object>(value_conv::cast(forward_like<T>(value), policy, parent));
             if (!value_)
@@ -310,6 +396,60 @@ struct visit_helper {
     }
 };
 
+/// Whether the caster of `T` could load an object of exactly the type `type` without conversions
+/// (`maybe`), certainly can't (`no`), or whether that can't be known yet (`unknown`, e.g. because
+/// `T` isn't registered yet). Used to skip alternatives when loading variants; casters not
+/// recognized here are always tried.
+enum class noconvert_match { no, maybe, unknown };
+
+template <typename S, bool V> std::true_type is_string_caster_impl(const string_caster<S, V> *);
+std::false_type is_string_caster_impl(...);
+template <typename T> std::true_type is_void_caster_impl(const void_caster<T> *);
+std::false_type is_void_caster_impl(...);
+
+template <typename T> using noconvert_caster_kind = std::integral_constant<int,
+    std::is_base_of<type_caster_generic, make_caster<T>>::value ? 1 :
+    std::is_same<intrinsic_t<T>, bool>::value ? 2 :
+    std::is_arithmetic<intrinsic_t<T>>::value && !is_std_char_type<intrinsic_t<T>>::value ? 3 :
+    decltype(is_string_caster_impl(std::declval<make_caster<T> *>()))::value ? 4 :
+    decltype(is_void_caster_impl(std::declval<make_caster<T> *>()))::value ? 5 : 0>;
+
+template <typename T> noconvert_match noconvert_loadable(PyTypeObject *, std::integral_constant<int, 0>) {
+    return noconvert_match::maybe;
+}
+template <typename T> noconvert_match noconvert_loadable(PyTypeObject *type, std::integral_constant<int, 1>) {
+    // Registered types (and their holders) only accept instances of (subclasses of) the bound type
+    struct typeinfo_of : type_caster_generic {
+        static const type_info *get(const type_caster_generic &caster) {
+            return caster.*(&typeinfo_of::typeinfo);
+        }
+    };
+    auto tinfo = typeinfo_of::get(make_caster<T>());
+    if (!tinfo)
+        return noconvert_match::unknown;
+    return PyType_IsSubtype(type, tinfo->type) ? noconvert_match::maybe : noconvert_match::no;
+}
+template <typename T> noconvert_match noconvert_loadable(PyTypeObject *type, std::integral_constant<int, 2>) {
+    return type == &PyBool_Type ? noconvert_match::maybe : noconvert_match::no;
+}
+template <typename T> noconvert_match noconvert_loadable(PyTypeObject *type, std::integral_constant<int, 3>) {
+    bool is_float = PyType_IsSubtype(type, &PyFloat_Type) != 0;
+    if (std::is_floating_point<intrinsic_t<T>>::value)
+        return is_float ? noconvert_match::maybe : noconvert_match::no;
+    // Integers are read with PyLong_AsLong(), which also accepts objects implementing __index__
+    // (or __int__ on older Python versions)
+    auto number = type->tp_as_number;
+    return !is_float && number && (number->nb_index || number->nb_int) ? noconvert_match::maybe
+                                                                       : noconvert_match::no;
+}
+template <typename T> noconvert_match noconvert_loadable(PyTypeObject *type, std::integral_constant<int, 4>) {
+    return PyType_IsSubtype(type, &PyUnicode_Type) || PyType_IsSubtype(type, &PyBytes_Type)
+        ? noconvert_match::maybe : noconvert_match::no;
+}
+template <typename T> noconvert_match noconvert_loadable(PyTypeObject *type, std::integral_constant<int, 5>) {
+    return type == Py_TYPE(Py_None) ? noconvert_match::maybe : noconvert_match::no;
+}
+
 /// Generic variant caster
 template <typename Variant> struct variant_caster;
 
@@ -317,6 +457,9 @@ template <template<typename...> class V, typename... Ts>
 struct variant_caster<V<Ts...>> {
     static_assert(sizeof...(Ts) > 0, "Variant must consist of at least one alternative.");
 
+    static constexpr size_t N = sizeof...(Ts);
+    using candidates = std::bitset<N>;
+
     template <typename U, typename... Us>
     bool load_alternative(handle src, bool convert, type_list<U, Us...>) {
         auto caster = make_caster<U>();
@@ -329,14 +472,56 @@ struct variant_caster<V<Ts...>> {
 
     bool load_alternative(handle, bool, type_list<>) { return false; }
 
+    template <size_t I> static bool load_index(variant_caster &self, handle src, bool convert) {
+        return self.load_alternative(src, convert, type_list<typename pack_element<I, Ts...>::type>{});
+    }
+
+    using loader = bool (*)(variant_caster &, handle, bool);
+
+    template <size_t... Is> static const std::array<loader, N> &loaders(index_sequence<Is...>) {
+        static const std::array<loader, N> loaders{{ &load_index<Is>... }};
+        return loaders;
+    }
+
+    /// The alternatives which could load an object of the given exact type without conversions.
+    /// The result is cached for builtin and registered types (which stay alive).
+    static candidates noconvert_candidates(PyTypeObject *type) {
+        static std::unordered_map<PyTypeObject *, candidates> table;
+        auto it = table.find(type);
+        if (it != table.end())
+            return it->second;
+
+        const noconvert_match matches[] = { noconvert_loadable<Ts>(type, noconvert_caster_kind<Ts>())... };
+        candidates result;
+        bool cacheable = !(type->tp_flags & Py_TPFLAGS_HEAPTYPE);
+        if (!cacheable) {
+            auto tinfo = get_type_info(type);
+            cacheable = tinfo && tinfo->type == type;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            result[i] = matches[i] != noconvert_match::no;
+            cacheable &= matches[i] != noconvert_match::unknown;
+        }
+        if (cacheable)
+            table.emplace(type, result);
+        return result;
+    }
+
     bool load(handle src, bool convert) {
+        if (!src)
+            return false;
+
         // Do a first pass without conversions to improve constructor resolution.
         // E.g. `py::int_(1).cast<variant<double, int>>()` needs to fill the `int`
         // slot of the variant. Without two-pass loading `double` would be filled
-        // because it appears first and a conversion is possible.
-        if (convert && load_alternative(src, false, type_list<Ts...>{}))
-            return true;
-        return load_alternative(src, convert, type_list<Ts...>{});
+        // because it appears first and a conversion is possible. This pass only tries the
+        // alternatives that can accept the type of `src` at all.
+        auto candidates = noconvert_candidates(Py_TYPE(src.ptr()));
+        auto &load_at = loaders(make_index_sequence<N>());
+        for (size_t i = 0; i < N; ++i)
+            if (candidates[i] && load_at[i](*this, src, false))
+                return true;
+        return convert && load_alternative(src, true, type_list<Ts...>{});
     }
 
     template <typename Variant>
@@ -355,6 +540,118 @@ struct type_caster<std::variant<Ts...>> : variant_caster<std::variant<Ts...>> {
 #endif
 NAMESPACE_END(detail)
 
+/** \rst
+    Return wrapper which takes ownership of a container and exposes it to Python as a read-only
+    sequence. Unlike the list conversion of e.g. ``std::vector``, the elements are only converted
+    when they are accessed (through indexing, slicing or iteration). Containers with contiguous
+    storage of arithmetic values also provide the buffer protocol.
+
+    .. code-block:: cpp
+
+        m.def("query", [](int n) { return py::make_lazy_sequence(run_query(n)); });
+\endrst */
+template <typename Container> class lazy_sequence {
+public:
+    using value_type = typename Container::value_type;
+
+    lazy_sequence(Container &&container) : container(std::move(container)) { }
+
+    const Container &get() const { return container; }
+
+private:
+    Container container;
+};
+
+/// Wraps a container (moved or copied) in a `lazy_sequence`
+template <typename Container>
+lazy_sequence<typename std::decay<Container>::type> make_lazy_sequence(Container &&container) {
+    return typename std::decay<Container>::type(std::forward<Container>(container));
+}
+
+NAMESPACE_BEGIN(detail)
+
+/// Creates the Python type of `lazy_sequence<Container>`, with the buffer protocol if the
+/// elements are arithmetic and stored contiguously
+template <typename Container, typename SFINAE = void> struct lazy_sequence_class {
+    static class_<lazy_sequence<Container>> make() {
+        return class_<lazy_sequence<Container>>(handle(), "lazy_sequence");
+    }
+};
+
+template <typename Container> struct lazy_sequence_class<Container, void_t<
+        decltype(format_descriptor<typename Container::value_type>::value),
+        decltype(std::declval<const Container &>().data())>> {
+    static class_<lazy_sequence<Container>> make() {
+        return class_<lazy_sequence<Container>>(handle(), "lazy_sequence", buffer_protocol())
+            .def_buffer([](const lazy_sequence<Container> &s, buffer_record &record) {
+                record.set(s.get().data(), {(ssize_t) s.get().size()});
+            });
+    }
+};
+
+template <typename Container> void register_lazy_sequence() {
+    using Sequence = lazy_sequence<Container>;
+    using value_conv = make_caster<typename Container::value_type>;
+    if (get_type_info(typeid(Sequence)))
+        return;
+
+    lazy_sequence_class<Container>::make()
+        .def("__len__", [](const Sequence &s) { return s.get().size(); })
+        .def("__getitem__", [](const Sequence &s, ssize_t i) -> typename Container::const_reference {
+            auto size = (ssize_t) s.get().size();
+            if (i < 0)
+                i += size;
+            if (i < 0 || i >= size)
+                throw index_error();
+            return *std::next(std::begin(s.get()), i);
+        }, return_value_policy::reference_internal)
+        .def("__getitem__", [](handle self, slice slice) {
+            const Container &c = self.cast<const Sequence &>().get();
+            size_t start, stop, step, slicelength;
+            if (!slice.compute(c.size(), &start, &stop, &step, &slicelength))
+                throw error_already_set();
+            list result(slicelength);
+            // An empty slice may have `start == -1` (e.g. `[::-1]` of an empty sequence)
+            if (slicelength == 0)
+                return result;
+            auto it = std::next(std::begin(c), (ssize_t) start);
+            for (size_t i = 0; i < slicelength; ++i) {
+                auto item = reinterpret_steal<object>(
+                    value_conv::cast(*it, return_value_policy::reference_internal, self));
+                if (!item)
+                    throw error_already_set();
+                PyList_SET_ITEM(result.ptr(), (ssize_t) i, item.release().ptr());
+                if (i + 1 < slicelength)
+                    std::advance(it, (ssize_t) step);
+            }
+            return result;
+        })
+        .def("__iter__", [](const Sequence &s) {
+            return make_iterator(std::begin(s.get()), std::end(s.get()));
+        }, keep_alive<0, 1>());
+}
+
+template <typename Container> struct type_caster<lazy_sequence<Container>> : type_caster_base<lazy_sequence<Container>> {
+    using base = type_caster_base<lazy_sequence<Container>>;
+    using base::cast;
+
+    static handle cast(const lazy_sequence<Container> &src, return_value_policy policy, handle parent) {
+        register_lazy_sequence<Container>();
+        return base::cast(src, policy, parent);
+    }
+
+    static handle cast(lazy_sequence<Container> &&src, return_value_policy policy, handle parent) {
+        register_lazy_sequence<Container>();
+        return base::cast(std::move(src), policy, parent);
+    }
+
+    static PYBIND11_DESCR name() {
+        return type_descr(_("Sequence[") + make_caster<typename Container::value_type>::name() + _("]"));
+    }
+};
+
+NAMESPACE_END(detail)
+
 inline std::ostream &operator<<(std::ostream &os, const handle &obj) {
     os << (std::string) str(obj);
     return os;
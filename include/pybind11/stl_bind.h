@@ -13,6 +13,7 @@
 #include "operators.h"
 
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 
 NAMESPACE_BEGIN(pybind11)
@@ -109,6 +110,172 @@ void vector_if_equal_operator(enable_if_t<is_comparable<Vector>::value, Class_>
     );
 }
 
+template <typename T> using is_buffer_value = bool_constant<
+    std::is_arithmetic<T>::value && !std::is_same<remove_cv_t<T>, long double>::value>;
+
+#if PY_MAJOR_VERSION >= 3
+// Copies the elements of a container (or e.g. the keys of a map) into a new bytearray, exported as a
+// memoryview of the matching format (which e.g. `numpy.asarray()` converts without further copies)
+template <typename T, typename Container, typename Get> object export_buffer_copy(const Container &c, Get get) {
+    using U = remove_cv_t<T>;
+    auto data = reinterpret_steal<object>(PyByteArray_FromStringAndSize(nullptr, (ssize_t) (c.size() * sizeof(U))));
+    if (!data)
+        throw error_already_set();
+    U *out = reinterpret_cast<U *>(PyByteArray_AS_STRING(data.ptr()));
+    for (auto &&item : c)
+        *out++ = get(item);
+    auto view = reinterpret_steal<object>(PyMemoryView_FromObject(data.ptr()));
+    if (!view)
+        throw error_already_set();
+    return view.attr("cast")(format_descriptor<U>::value);
+}
+#endif
+
+// The number of items an iterable is expected to produce (or 0 if it can't tell)
+inline size_t length_hint(handle h) {
+#if PY_VERSION_HEX >= 0x03040000
+    ssize_t n = PyObject_LengthHint(h.ptr(), 0);
+#else
+    ssize_t n = _PyObject_LengthHint(h.ptr(), 0);
+#endif
+    if (n < 0) {
+        PyErr_Clear();
+        return 0;
+    }
+    return (size_t) n;
+}
+
+// Converts the item at `index` of an iterable passed to `extend`/`assign`, reporting a mismatched
+// type as a TypeError (like a mismatched argument) rather than a cast error
+template <typename T> T vector_item_cast(handle h, size_t index) {
+    try {
+        return h.cast<T>();
+    } catch (const cast_error &) {
+        throw type_error("Unable to convert item " + std::to_string(index) + " of type '" +
+                         std::string(Py_TYPE(h.ptr())->tp_name) + "' to C++ type '" +
+                         type_id<T>() + "'");
+    }
+}
+
+template <typename Vector> auto vector_reserve(Vector &v, size_t n) -> decltype(v.reserve(n), void()) { v.reserve(n); }
+template <typename Vector> void vector_reserve(Vector &, ...) { }
+
+// Whether every value of the arithmetic type S can be represented by T
+template <typename T, typename S> using numeric_fits = bool_constant<
+    std::is_floating_point<T>::value || std::is_same<S, bool>::value ||
+    (std::is_signed<S>::value == std::is_signed<T>::value && sizeof(S) <= sizeof(T)) ||
+    (std::is_unsigned<S>::value && std::is_signed<T>::value && sizeof(S) < sizeof(T))>;
+
+template <typename T, typename S> bool numeric_in_range(S s, std::true_type /* signed S */) {
+    return s < 0 ? std::is_signed<T>::value && (long long) s >= (long long) std::numeric_limits<T>::min()
+                 : (unsigned long long) s <= (unsigned long long) std::numeric_limits<T>::max();
+}
+template <typename T, typename S> bool numeric_in_range(S s, std::false_type /* unsigned S */) {
+    return (unsigned long long) s <= (unsigned long long) std::numeric_limits<T>::max();
+}
+
+// Appends the items of a one-dimensional buffer of S values to `v`, converting them to the value type
+template <typename S, typename Vector> void vector_append_buffer(Vector &v, const buffer_info &info) {
+    using T = typename Vector::value_type;
+    const char *p = static_cast<const char *>(info.ptr);
+    const size_t old_size = v.size();
+    vector_reserve(v, old_size + (size_t) info.shape[0]);
+    for (ssize_t i = 0; i < info.shape[0]; ++i, p += info.strides[0]) {
+        S s;
+        std::memcpy(&s, p, sizeof(S));
+        if (!numeric_fits<T, S>::value && !numeric_in_range<T>(s, std::is_signed<S>())) {
+            v.erase(v.begin() + (typename Vector::difference_type) old_size, v.end());
+            throw value_error("Buffer item " + std::to_string(i) + " is out of range for the vector's value type");
+        }
+        v.push_back(static_cast<T>(s));
+    }
+}
+
+// Appends the contents of a one-dimensional buffer of numbers (of any struct-module format) to `v`.
+// Integers may be converted to other integer or floating point types, floating point numbers only
+// to floating point types.
+template <typename Vector> void vector_extend_buffer(Vector &v, buffer b) {
+    using T = typename Vector::value_type;
+    auto info = b.request();
+    if (info.ndim != 1)
+        throw type_error("Only 1D buffers can be copied to a vector");
+
+    const uint16_t one = 1;
+    const bool little_endian = *reinterpret_cast<const char *>(&one) == 1;
+    const char *format = info.format.c_str();
+    if (*format == '@' || *format == '=' || *format == (little_endian ? '<' : '>'))
+        ++format;
+    const char code = format[0] != '\0' && format[1] == '\0' ? format[0] : '\0';
+    const auto size = info.itemsize;
+    const bool is_signed = std::strchr("bhilqn", code) != nullptr,
+               is_unsigned = std::strchr("BHILQN", code) != nullptr,
+               is_float = code == 'f' || code == 'd',
+               is_bool = code == '?';
+
+    const bool compatible =
+        std::is_same<T, bool>::value ? is_bool :
+        std::is_integral<T>::value ? is_signed || is_unsigned || is_bool :
+        code != '\0';
+    if (code == '\0' || !compatible)
+        throw type_error("Format mismatch (Python: " + info.format + " C++: " + format_descriptor<T>::format() + ")");
+
+    if (is_bool && size == 1) vector_append_buffer<bool>(v, info);
+    else if (is_float && size == 4) vector_append_buffer<float>(v, info);
+    else if (is_float && size == 8) vector_append_buffer<double>(v, info);
+    else if (is_signed && size == 1) vector_append_buffer<int8_t>(v, info);
+    else if (is_signed && size == 2) vector_append_buffer<int16_t>(v, info);
+    else if (is_signed && size == 4) vector_append_buffer<int32_t>(v, info);
+    else if (is_signed && size == 8) vector_append_buffer<int64_t>(v, info);
+    else if (is_unsigned && size == 1) vector_append_buffer<uint8_t>(v, info);
+    else if (is_unsigned && size == 2) vector_append_buffer<uint16_t>(v, info);
+    else if (is_unsigned && size == 4) vector_append_buffer<uint32_t>(v, info);
+    else if (is_unsigned && size == 8) vector_append_buffer<uint64_t>(v, info);
+    else
+        throw type_error("Unsupported buffer format: " + info.format);
+}
+
+template <typename, typename, typename... Args> void vector_numeric_modifiers(const Args &...) { }
+
+// Bulk conversion from buffers of numbers (e.g. NumPy arrays), with a single reserve and a typed loop
+template <typename Vector, typename Class_>
+void vector_numeric_modifiers(enable_if_t<is_buffer_value<typename Vector::value_type>::value, Class_> &cl) {
+    cl.def("extend",
+       [](Vector &v, buffer b) { vector_extend_buffer(v, b); },
+       arg("L"),
+       "Extend the list by appending all the items of a 1D buffer of numbers"
+    );
+
+    cl.def("assign",
+       [](Vector &v, buffer b) {
+           Vector result;
+           vector_extend_buffer(result, b);
+           v.swap(result);
+       },
+       arg("L"),
+       "Replace the contents with the items of a 1D buffer of numbers"
+    );
+
+    cl.def_static("from_numpy",
+       [](buffer b) {
+           Vector v;
+           vector_extend_buffer(v, b);
+           return v;
+       },
+       arg("array"),
+       "Create a new list from a 1D NumPy array (or other buffer) of numbers"
+    );
+
+#if PY_MAJOR_VERSION >= 3
+    using T = typename Vector::value_type;
+    cl.def("to_numpy",
+       [](const Vector &v) {
+           return module::import("numpy").attr("asarray")(export_buffer_copy<T>(v, [](const T &x) { return x; }));
+       },
+       "Return a NumPy array with a copy of the items"
+    );
+#endif
+}
+
 // Vector modifiers -- requires a copyable vector_type:
 // (Technically, some of these (pop and __delitem__) don't actually require copyability, but it seems
 // silly to allow deletion but not insertion, so include them here too.)
@@ -143,6 +310,44 @@ void vector_modifiers(enable_if_t<std::is_copy_constructible<typename Vector::va
        "Extend the list by appending all the items in the given list"
     );
 
+    cl.def("assign",
+       [](Vector &v, const Vector &src) { v = src; },
+       arg("L"),
+       "Replace the contents with the items of the given list"
+    );
+
+    vector_numeric_modifiers<Vector, Class_>(cl);
+
+    cl.def("extend",
+       [](Vector &v, iterable it) {
+           const size_t old_size = v.size();
+           vector_reserve(v, old_size + length_hint(it));
+           try {
+               size_t index = 0;
+               for (handle h : it)
+                   v.push_back(vector_item_cast<T>(h, index++));
+           } catch (...) {
+               v.erase(v.begin() + (DiffType) old_size, v.end());
+               throw;
+           }
+       },
+       arg("L"),
+       "Extend the list by appending all the items of an iterable"
+    );
+
+    cl.def("assign",
+       [](Vector &v, iterable it) {
+           Vector result;
+           vector_reserve(result, length_hint(it));
+           size_t index = 0;
+           for (handle h : it)
+               result.push_back(vector_item_cast<T>(h, index++));
+           v.swap(result);
+       },
+       arg("L"),
+       "Replace the contents with the items of an iterable"
+    );
+
     cl.def("insert",
         [](Vector &v, SizeType i, const T &x) {
             if (i > v.size())
@@ -265,9 +470,9 @@ void vector_accessor(enable_if_t<!vector_needs_copy<Vector>::value, Class_> &cl)
     using ItType   = typename Vector::iterator;
 
     cl.def("__getitem__",
-        [](Vector &v, SizeType i) -> T & {
+        [](Vector &v, SizeType i) -> value_or_error<T &> {
             if (i >= v.size())
-                throw index_error();
+                return error_result(PyExc_IndexError);
             return v[i];
         },
         return_value_policy::reference_internal // ref + keepalive
@@ -290,9 +495,9 @@ void vector_accessor(enable_if_t<vector_needs_copy<Vector>::value, Class_> &cl)
     using SizeType = typename Vector::size_type;
     using ItType   = typename Vector::iterator;
     cl.def("__getitem__",
-        [](const Vector &v, SizeType i) -> T {
+        [](const Vector &v, SizeType i) -> value_or_error<T> {
             if (i >= v.size())
-                throw index_error();
+                return error_result(PyExc_IndexError);
             return v[i];
         }
     );
@@ -467,44 +672,148 @@ NAMESPACE_BEGIN(detail)
 /* Fallback functions */
 template <typename, typename, typename... Args> void map_if_insertion_operator(const Args &...) { }
 template <typename, typename, typename... Args> void map_assignment(const Args &...) { }
+template <typename, typename, typename... Args> void map_modifiers(const Args &...) { }
+template <typename, typename, typename... Args> void map_if_reserve(const Args &...) { }
+template <typename, typename, typename... Args> void map_key_buffer(const Args &...) { }
+template <typename, typename, typename... Args> void map_value_buffer(const Args &...) { }
+
+// Sets the value of a key: mapped types which are copy-assignable are assigned in place...
+template <typename Map, typename K, typename V>
+enable_if_t<std::is_copy_assignable<typename Map::mapped_type>::value> map_set(Map &m, K &&k, V &&v) {
+    auto it = m.find(k);
+    if (it != m.end()) it->second = std::forward<V>(v);
+    else m.emplace(std::forward<K>(k), std::forward<V>(v));
+}
+
+// ... otherwise, the only way to update the value is to erase and reinsert it (we can't use
+// m[k] = v; because the value type might not be default constructable)
+template <typename Map, typename K, typename V>
+enable_if_t<!std::is_copy_assignable<typename Map::mapped_type>::value> map_set(Map &m, K &&k, V &&v) {
+    auto it = m.find(k);
+    if (it != m.end()) m.erase(it);
+    m.emplace(std::forward<K>(k), std::forward<V>(v));
+}
 
-// Map assignment when copy-assignable: just copy the value
+template <typename Map> auto map_reserve(Map &m, size_t n) -> decltype(m.reserve(n), void()) { m.reserve(n); }
+template <typename Map> void map_reserve(Map &, ...) { }
+
+// Map assignment when the value is copy-constructible
 template <typename Map, typename Class_>
-void map_assignment(enable_if_t<std::is_copy_assignable<typename Map::mapped_type>::value, Class_> &cl) {
+void map_assignment(enable_if_t<std::is_copy_constructible<typename Map::mapped_type>::value, Class_> &cl) {
     using KeyType = typename Map::key_type;
     using MappedType = typename Map::mapped_type;
 
     cl.def("__setitem__",
-           [](Map &m, const KeyType &k, const MappedType &v) {
-               auto it = m.find(k);
-               if (it != m.end()) it->second = v;
-               else m.emplace(k, v);
-           }
+           [](Map &m, const KeyType &k, const MappedType &v) { map_set(m, k, v); }
     );
 }
 
-// Not copy-assignable, but still copy-constructible: we can update the value by erasing and reinserting
-template<typename Map, typename Class_>
-void map_assignment(enable_if_t<
-        !std::is_copy_assignable<typename Map::mapped_type>::value &&
-        std::is_copy_constructible<typename Map::mapped_type>::value,
-        Class_> &cl) {
+// Bulk construction and updates, which convert all entries in a single call
+template <typename Map, typename Class_>
+void map_modifiers(enable_if_t<std::is_copy_constructible<typename Map::key_type>::value &&
+                               std::is_copy_constructible<typename Map::mapped_type>::value, Class_> &cl) {
     using KeyType = typename Map::key_type;
     using MappedType = typename Map::mapped_type;
 
-    cl.def("__setitem__",
-           [](Map &m, const KeyType &k, const MappedType &v) {
-               // We can't use m[k] = v; because value type might not be default constructable
-               auto r = m.emplace(k, v);
-               if (!r.second) {
-                   // value type is not copy assignable so the only way to insert it is to erase it first...
-                   m.erase(r.first);
-                   m.emplace(k, v);
+    auto update_from_dict = [](Map &m, dict d) {
+        map_reserve(m, m.size() + d.size());
+        for (auto item : d)
+            map_set(m, item.first.template cast<KeyType>(), item.second.template cast<MappedType>());
+    };
+
+    // Inserts or assigns all entries of `other`, moving its values
+    auto merge = [](Map &m, Map &other) {
+        map_reserve(m, m.size() + other.size());
+        for (auto &kv : other)
+            map_set(m, kv.first, std::move(kv.second));
+    };
+
+    cl.def("__init__", [update_from_dict](Map &m, dict d) {
+        new (&m) Map();
+        try {
+            update_from_dict(m, d);
+        } catch (...) {
+            m.~Map();
+            throw;
+        }
+    });
+
+    cl.def("update",
+           [](Map &m, const Map &other) {
+               if (&m == &other)
+                   return;
+               map_reserve(m, m.size() + other.size());
+               for (auto &kv : other)
+                   map_set(m, kv.first, kv.second);
+           },
+           arg("other")
+    );
+
+    // Entries are converted into a temporary first, so that a failed conversion leaves the map unchanged
+    cl.def("update",
+           [update_from_dict, merge](Map &m, dict d) {
+               Map entries;
+               update_from_dict(entries, d);
+               merge(m, entries);
+           },
+           arg("other")
+    );
+
+    cl.def("update",
+           [merge](Map &m, iterable it) {
+               Map entries;
+               for (handle h : it) {
+                   if (!isinstance<sequence>(h) || len(h) != 2)
+                       throw value_error("update(): expected an iterable of (key, value) pairs");
+                   auto kv = reinterpret_borrow<sequence>(h);
+                   map_set(entries, kv[0].template cast<KeyType>(), kv[1].template cast<MappedType>());
                }
-           }
+               merge(m, entries);
+           },
+           arg("other"),
+           "Insert or assign all entries of a map, dict or iterable of (key, value) pairs"
+    );
+}
+
+template <typename Map, typename Class_> auto map_if_reserve(Class_ &cl)
+-> decltype(std::declval<Map &>().reserve(0), void()) {
+    cl.def("reserve",
+           [](Map &m, size_t n) { m.reserve(n); },
+           arg("n"),
+           "Reserve space for at least n entries"
+    );
+}
+
+#if PY_MAJOR_VERSION >= 3
+template <typename Map, typename Class_>
+void map_key_buffer(enable_if_t<is_buffer_value<typename Map::key_type>::value, Class_> &cl) {
+    cl.def("keys_buffer",
+           [](const Map &m) { return export_buffer_copy<typename Map::key_type>(m, [](const typename Map::value_type &kv) { return kv.first; }); },
+           "Return a memoryview of a copy of all keys"
+    );
+}
+
+template <typename Map, typename Class_>
+void map_value_buffer(enable_if_t<is_buffer_value<typename Map::mapped_type>::value, Class_> &cl) {
+    cl.def("values_buffer",
+           [](const Map &m) { return export_buffer_copy<typename Map::mapped_type>(m, [](const typename Map::value_type &kv) { return kv.second; }); },
+           "Return a memoryview of a copy of all values"
     );
 }
+#endif
+
+// The Python instance wrapping a bound map (so that values can be returned by reference)
+template <typename Map> object map_self(Map &m) {
+    return reinterpret_steal<object>(make_caster<Map>::cast(&m, return_value_policy::reference, handle()));
+}
 
+// Converts a key or value, returned by reference where applicable; returns a new reference
+template <typename T> PyObject *map_cast(const T &value, handle self) {
+    handle result = make_caster<T>::cast(value, return_value_policy::reference_internal, self);
+    if (!result)
+        throw error_already_set();
+    return result.ptr();
+}
 
 template <typename Map, typename Class_> auto map_if_insertion_operator(Class_ &cl, std::string const &name)
 -> decltype(std::declval<std::ostream&>() << std::declval<typename Map::key_type>() << std::declval<typename Map::mapped_type>(), void()) {
@@ -553,23 +862,80 @@ class_<Map, holder_type> bind_map(module &m, const std::string &name, Args&&...
            keep_alive<0, 1>() /* Essential: keep list alive while iterator exists */
     );
 
+    cl.def("keys",
+           [](Map &m) {
+               auto self = detail::map_self(m);
+               list result(m.size());
+               size_t index = 0;
+               for (auto &kv : m)
+                   PyList_SET_ITEM(result.ptr(), (ssize_t) index++, detail::map_cast(kv.first, self));
+               return result;
+           },
+           "Return a list of all keys"
+    );
+
+    cl.def("values",
+           [](Map &m) {
+               auto self = detail::map_self(m);
+               list result(m.size());
+               size_t index = 0;
+               for (auto &kv : m)
+                   PyList_SET_ITEM(result.ptr(), (ssize_t) index++, detail::map_cast(kv.second, self));
+               return result;
+           },
+           "Return a list of all values"
+    );
+
     cl.def("items",
            [](Map &m) { return make_iterator(m.begin(), m.end()); },
            keep_alive<0, 1>() /* Essential: keep list alive while iterator exists */
     );
 
+    cl.def("items_list",
+           [](Map &m) {
+               auto self = detail::map_self(m);
+               list result(m.size());
+               size_t index = 0;
+               for (auto &kv : m) {
+                   tuple item(2);
+                   PyTuple_SET_ITEM(item.ptr(), 0, detail::map_cast(kv.first, self));
+                   PyTuple_SET_ITEM(item.ptr(), 1, detail::map_cast(kv.second, self));
+                   PyList_SET_ITEM(result.ptr(), (ssize_t) index++, item.release().ptr());
+               }
+               return result;
+           },
+           "Return a list of all (key, value) pairs"
+    );
+
     cl.def("__getitem__",
-        [](Map &m, const KeyType &k) -> MappedType & {
+        [](Map &m, const KeyType &k) -> value_or_error<MappedType &> {
             auto it = m.find(k);
             if (it == m.end())
-              throw key_error();
-           return it->second;
+                return error_result(PyExc_KeyError);
+            return it->second;
         },
         return_value_policy::reference_internal // ref + keepalive
     );
 
+    cl.def("get",
+        [](Map &m, const KeyType &k, object default_) -> object {
+            auto it = m.find(k);
+            if (it == m.end())
+                return default_;
+            return reinterpret_steal<object>(detail::map_cast(it->second, detail::map_self(m)));
+        },
+        arg("key"), arg("default") = none(),
+        "Return the value for key if key is in the map, else default"
+    );
+
     // Assignment provided only if the type is copyable
     detail::map_assignment<Map, Class_>(cl);
+    detail::map_modifiers<Map, Class_>(cl);
+    detail::map_if_reserve<Map, Class_>(cl);
+#if PY_MAJOR_VERSION >= 3
+    detail::map_key_buffer<Map, Class_>(cl);
+    detail::map_value_buffer<Map, Class_>(cl);
+#endif
 
     cl.def("__delitem__",
            [](Map &m, const KeyType &k) {
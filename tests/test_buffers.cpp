@@ -105,6 +105,20 @@ public:
 
 struct DerivedPTMFBuffer : public PTMFBuffer { };
 
+// Buffers described by filling in a `py::buffer_record`, without heap allocations
+struct RecordBuffer {
+    int16_t data[2][3] = {{1, 2, 3}, {4, 5, 6}};
+    bool fail = false;
+
+    void fill_buffer(py::buffer_record &record) {
+        if (fail)
+            throw std::runtime_error("Buffer unavailable");
+        record.set(&data[0][0], {2, 3});
+    }
+};
+
+struct TransposedRecordBuffer : RecordBuffer { };
+
 test_initializer buffers([](py::module &m) {
     py::class_<Matrix> mtx(m, "Matrix", py::buffer_protocol());
 
@@ -163,4 +177,16 @@ test_initializer buffers([](py::module &m) {
         .def(py::init<>())
         .def_readwrite("value", (int32_t DerivedPTMFBuffer::*) &DerivedPTMFBuffer::value)
         .def_buffer(&DerivedPTMFBuffer::get_buffer_info);
+
+    py::class_<RecordBuffer>(m, "RecordBuffer", py::buffer_protocol(), py::dynamic_attr())
+        .def(py::init<>())
+        .def_readwrite("fail", &RecordBuffer::fail)
+        .def_buffer(&RecordBuffer::fill_buffer);
+
+    // A read-only, non-contiguous view
+    py::class_<TransposedRecordBuffer>(m, "TransposedRecordBuffer", py::buffer_protocol())
+        .def(py::init<>())
+        .def_buffer([](const TransposedRecordBuffer &b, py::buffer_record &record) {
+            record.set(&b.data[0][0], {3, 2}, {sizeof(int16_t), 3 * sizeof(int16_t)});
+        });
 });
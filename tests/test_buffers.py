@@ -1,13 +1,13 @@
 import struct
+import zlib
 import pytest
 from pybind11_tests import Matrix, ConstructorStats, PTMFBuffer, ConstPTMFBuffer, DerivedPTMFBuffer
 
-pytestmark = pytest.requires_numpy
-
 with pytest.suppress(ImportError):
     import numpy as np
 
 
+@pytest.requires_numpy
 def test_from_python():
     with pytest.raises(RuntimeError) as excinfo:
         Matrix(np.array([1, 2, 3]))  # trying to assign a 1D array
@@ -33,6 +33,7 @@ def test_from_python():
 
 # PyPy: Memory leak in the "np.array(m, copy=False)" call
 # https://bitbucket.org/pypy/pypy/issues/2444
+@pytest.requires_numpy
 @pytest.unsupported_on_pypy
 def test_to_python():
     m = Matrix(5, 5)
@@ -64,6 +65,7 @@ def test_to_python():
     assert cstats.move_assignments == 0
 
 
+@pytest.requires_numpy
 @pytest.unsupported_on_pypy
 def test_inherited_protocol():
     """SquareMatrix is derived from Matrix and inherits the buffer protocol"""
@@ -81,3 +83,44 @@ def test_ptmf():
         buf.value = 0x12345678
         value = struct.unpack('i', bytearray(buf))[0]
         assert value == 0x12345678
+
+
+def test_buffer_record():
+    from pybind11_tests import RecordBuffer, TransposedRecordBuffer
+
+    buf = RecordBuffer()
+    view = memoryview(buf)
+    assert view.format == 'h'
+    assert view.itemsize == 2
+    assert view.ndim == 2
+    assert view.shape == (2, 3)
+    assert view.strides == (6, 2)
+    assert not view.readonly
+    assert view.tolist() == [[1, 2, 3], [4, 5, 6]]
+    view[1, 2] = 60
+    assert struct.unpack('6h', bytes(buf)) == (1, 2, 3, 4, 5, 60)
+    view.release()
+
+    # The buffer implementation is cached per type, including Python subclasses
+    class PyRecordBuffer(RecordBuffer):
+        pass
+
+    for _ in range(2):
+        assert memoryview(PyRecordBuffer()).tolist() == [[1, 2, 3], [4, 5, 6]]
+
+    buf.fail = True
+    with pytest.raises(RuntimeError) as excinfo:
+        memoryview(buf)
+    assert str(excinfo.value) == "Buffer unavailable"
+
+    view = memoryview(TransposedRecordBuffer())
+    assert view.shape == (3, 2)
+    assert view.strides == (2, 6)
+    assert view.readonly
+    assert view.tolist() == [[1, 4], [2, 5], [3, 6]]
+    # Consumers not supporting strides or requiring writable buffers are refused
+    with pytest.raises((TypeError, BufferError)):
+        zlib.crc32(TransposedRecordBuffer())
+    with pytest.raises((TypeError, BufferError)):
+        struct.pack_into('h', TransposedRecordBuffer(), 0, 1)
+    assert zlib.crc32(RecordBuffer()) == zlib.crc32(struct.pack('6h', 1, 2, 3, 4, 5, 6))
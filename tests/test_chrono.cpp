@@ -11,7 +11,7 @@
 
 #include "pybind11_tests.h"
 #include "constructor_stats.h"
-#include <pybind11/chrono.h>
+#include <pybind11/chrono_numpy.h>
 
 // Return the current time off the wall clock
 std::chrono::system_clock::time_point test_chrono1() {
@@ -53,6 +53,20 @@ std::chrono::duration<double> test_chrono_float_diff(std::chrono::duration<float
     return a - b;
 }
 
+// Round trip a time point in UTC
+py::utc_time_point<> test_chrono_utc(py::utc_time_point<> t) {
+    return t;
+}
+
+// A UTC time point a given number of microseconds after the epoch
+py::utc_time_point<std::chrono::microseconds> test_chrono_utc_from_epoch(long long us) {
+    return py::utc_time_point<std::chrono::microseconds>(std::chrono::microseconds(us));
+}
+
+long long test_chrono_utc_to_epoch(py::utc_time_point<std::chrono::microseconds> t) {
+    return (long long) t.time_since_epoch().count();
+}
+
 test_initializer chrono([] (py::module &m) {
     m.def("test_chrono1", &test_chrono1);
     m.def("test_chrono2", &test_chrono2);
@@ -62,4 +76,31 @@ test_initializer chrono([] (py::module &m) {
     m.def("test_chrono6", &test_chrono6);
     m.def("test_chrono7", &test_chrono7);
     m.def("test_chrono_float_diff", &test_chrono_float_diff);
+    m.def("test_chrono_utc", &test_chrono_utc);
+    m.def("test_chrono_utc_from_epoch", &test_chrono_utc_from_epoch);
+    m.def("test_chrono_utc_to_epoch", &test_chrono_utc_to_epoch);
+    m.attr("system_clock_ns") = std::is_same<std::chrono::system_clock::duration, std::chrono::nanoseconds>::value;
+
+    // Vectors of time points and durations convert to and from datetime64/timedelta64 arrays
+    using time_points = std::vector<std::chrono::system_clock::time_point>;
+    m.def("test_chrono_datetime64", [](const time_points &t) {
+        time_points result;
+        for (auto &p : t)
+            result.push_back(p + std::chrono::seconds(1));
+        return result;
+    });
+    m.def("test_chrono_timedelta64", [](const std::vector<std::chrono::microseconds> &d) {
+        return d;
+    });
+    m.def("test_chrono_timedelta64_noconvert", [](const std::vector<std::chrono::microseconds> &d) {
+        return d.size();
+    }, py::arg().noconvert());
+    // Coarse durations can exceed the ~292 year range of nanosecond counts
+    m.def("test_chrono_timedelta64_hours", [](long long hours) {
+        return std::vector<std::chrono::hours>{std::chrono::hours(hours)};
+    });
+    m.def("test_chrono_datetime64_hours", [](long long hours) {
+        using time_point = std::chrono::time_point<std::chrono::system_clock, std::chrono::hours>;
+        return std::vector<time_point>{time_point(std::chrono::hours(hours))};
+    });
 });
@@ -1,3 +1,7 @@
+import pytest
+
+with pytest.suppress(ImportError):
+    import numpy as np
 
 
 def test_chrono_system_clock():
@@ -118,3 +122,101 @@ def test_floating_point_duration():
     diff = test_chrono_float_diff(43.789012, 1.123456)
     assert diff.seconds == 42
     assert 665556 <= diff.microseconds <= 665557
+
+
+def test_chrono_utc():
+    from pybind11_tests import (test_chrono_utc, test_chrono_utc_from_epoch,
+                                test_chrono_utc_to_epoch)
+    import datetime
+
+    for date in [datetime.datetime(2017, 3, 1, 12, 30, 15, 123456),
+                 datetime.datetime(2000, 2, 29, 23, 59, 59, 999999),
+                 datetime.datetime(1969, 12, 31, 23, 59, 59, 500000)]:
+        assert test_chrono_utc(date) == date
+
+    # The full range of datetime fits in microseconds (but not in nanoseconds)
+    for date in [datetime.datetime(1, 1, 1), datetime.datetime(9999, 12, 31, 23, 59, 59, 999999)]:
+        assert test_chrono_utc_from_epoch(test_chrono_utc_to_epoch(date)) == date
+
+    epoch = datetime.datetime(1970, 1, 1)
+    for us in [0, 1, -1, 951782400 * 10**6, -2208988800 * 10**6 + 17, 253402300799 * 10**6]:
+        date = epoch + datetime.timedelta(microseconds=us)
+        assert test_chrono_utc_from_epoch(us) == date
+        assert test_chrono_utc_to_epoch(date) == us
+
+    # Aware datetimes are converted to UTC
+    tz = datetime.timezone(datetime.timedelta(hours=-5, minutes=-30))
+    aware = datetime.datetime(2017, 3, 1, 12, 0, tzinfo=tz)
+    assert test_chrono_utc(aware) == datetime.datetime(2017, 3, 1, 17, 30)
+
+
+def test_chrono_utc_range():
+    from pybind11_tests import test_chrono_utc, system_clock_ns
+    import datetime
+
+    if not system_clock_ns:
+        pytest.skip("the default duration of system_clock is not nanoseconds")
+
+    # Nanosecond counts span 1677-09-21 00:12:43.145224192 to 2262-04-11 23:47:16.854775807
+    for date in [datetime.datetime(1677, 9, 21, 0, 12, 43, 145225),
+                 datetime.datetime(2262, 4, 11, 23, 47, 16, 854775)]:
+        assert test_chrono_utc(date) == date
+    for date in [datetime.datetime(1677, 9, 21, 0, 12, 43, 145224),
+                 datetime.datetime(2262, 4, 11, 23, 47, 16, 854776),
+                 datetime.datetime(1600, 1, 1), datetime.datetime(2300, 1, 1)]:
+        with pytest.raises(TypeError):
+            test_chrono_utc(date)
+
+
+@pytest.requires_numpy
+def test_chrono_numpy():
+    from pybind11_tests import test_chrono_datetime64, test_chrono_timedelta64
+    import datetime
+
+    dates = np.array(["2017-03-01T12:30:15.123456789", "1969-12-31T23:59:59"],
+                     dtype="datetime64[ns]")
+    result = test_chrono_datetime64(dates)
+    assert result.dtype == np.dtype("datetime64[ns]")
+    assert np.all(result == dates + np.timedelta64(1, "s"))
+
+    # Other units are converted by NumPy
+    result = test_chrono_datetime64(dates.astype("datetime64[s]"))
+    assert np.all(result == dates.astype("datetime64[s]") + np.timedelta64(1, "s"))
+
+    # Sequences of datetime objects still work
+    result = test_chrono_datetime64([datetime.datetime(2017, 3, 1)])
+    assert result.dtype == np.dtype("datetime64[ns]")
+
+    deltas = np.array([1, -2, 3000], dtype="timedelta64[us]")
+    result = test_chrono_timedelta64(deltas)
+    assert result.dtype == np.dtype("timedelta64[ns]")
+    assert np.all(result == deltas)
+
+
+@pytest.requires_numpy
+def test_chrono_numpy_range():
+    from pybind11_tests import test_chrono_timedelta64_hours, test_chrono_datetime64_hours
+
+    assert test_chrono_timedelta64_hours(-24)[0] == np.timedelta64(-1, "D")
+    assert test_chrono_datetime64_hours(24)[0] == np.datetime64("1970-01-02", "ns")
+
+    # Roughly 300 years overflow a nanosecond count
+    hours = 300 * 365 * 24
+    for f in [test_chrono_timedelta64_hours, test_chrono_datetime64_hours]:
+        for h in [hours, -hours]:
+            with pytest.raises(ValueError) as excinfo:
+                f(h)
+            assert "out of range" in str(excinfo.value)
+
+
+@pytest.requires_numpy
+def test_chrono_numpy_noconvert():
+    from pybind11_tests import test_chrono_timedelta64_noconvert as f
+
+    deltas = np.array([1, 2, 3], dtype="timedelta64[ns]")
+    assert f(deltas) == 3
+
+    # Other units and non-contiguous arrays need a conversion
+    for arr in [deltas.astype("timedelta64[us]"), deltas[::2]]:
+        with pytest.raises(TypeError):
+            f(arr)
@@ -1,6 +1,7 @@
 #include <pybind11/embed.h>
 #include <catch.hpp>
 
+#include <chrono>
 #include <thread>
 
 namespace py = pybind11;
@@ -24,12 +25,20 @@ class PyWidget final : public Widget {
     int the_answer() const override { PYBIND11_OVERLOAD_PURE(int, Widget, the_answer); }
 };
 
+class WidgetError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 PYBIND11_EMBEDDED_MODULE(widget_module, m) {
     py::class_<Widget, PyWidget>(m, "Widget")
         .def(py::init<std::string>())
         .def_property_readonly("the_message", &Widget::the_message);
 
     m.def("add", [](int i, int j) { return i + j; });
+
+    py::register_exception<WidgetError>(m, "WidgetError");
+    m.def("throw_widget_error", []() { throw WidgetError("widget"); });
 }
 
 PYBIND11_EMBEDDED_MODULE(throw_exception, ) {
@@ -152,14 +161,15 @@ TEST_CASE("Subinterpreter") {
     }
     REQUIRE(has_pybind11_internals_builtin());
     REQUIRE(has_pybind11_internals_static());
+    auto main_internals = &py::detail::get_internals();
+    auto main_widget = py::module::import("widget_module").attr("Widget");
 
     /// Create and switch to a subinterpreter.
     auto main_tstate = PyThreadState_Get();
     auto sub_tstate = Py_NewInterpreter();
 
-    // Subinterpreters get their own copy of builtins. detail::get_internals() still
-    // works by returning from the static variable, i.e. all interpreters share a single
-    // global pybind11::internals;
+    // Subinterpreters get their own copy of builtins and, as soon as pybind11 is used in them,
+    // their own pybind11::internals.
     REQUIRE_FALSE(has_pybind11_internals_builtin());
     REQUIRE(has_pybind11_internals_static());
 
@@ -171,6 +181,11 @@ TEST_CASE("Subinterpreter") {
 
         // Function bindings should still work.
         REQUIRE(m.attr("add")(1, 2).cast<int>() == 3);
+
+        // The module was initialized again, registering its types in the new internals.
+        REQUIRE(has_pybind11_internals_builtin());
+        REQUIRE(&py::detail::get_internals() != main_internals);
+        REQUIRE_FALSE(m.attr("Widget").is(main_widget));
     }
 
     // Restore main interpreter.
@@ -179,6 +194,105 @@ TEST_CASE("Subinterpreter") {
 
     REQUIRE(py::hasattr(py::module::import("__main__"), "main_tag"));
     REQUIRE(py::hasattr(py::module::import("widget_module"), "extension_module_tag"));
+    REQUIRE(&py::detail::get_internals() == main_internals);
+}
+
+TEST_CASE("Reimport a C++ module") {
+    // Initializing a module twice in the same interpreter would register its types twice.
+    auto m = py::module::import("widget_module");
+    py::module::import("sys").attr("modules").attr("pop")("widget_module");
+    REQUIRE(py::module::import("widget_module").is(m));
+}
+
+TEST_CASE("RAII subinterpreters") {
+    static_assert(std::is_move_constructible<py::subinterpreter>::value, "");
+    static_assert(!std::is_move_assignable<py::subinterpreter>::value, "");
+    static_assert(!std::is_copy_constructible<py::subinterpreter>::value, "");
+    static_assert(!std::is_copy_assignable<py::subinterpreter>::value, "");
+
+    auto main_tstate = PyThreadState_Get();
+    auto main_internals = &py::detail::get_internals();
+    py::module::import("widget_module").attr("extension_module_tag") = "main";
+    {
+        py::subinterpreter sub;
+        REQUIRE(PyThreadState_Get() == main_tstate);
+        REQUIRE(sub.state() != main_tstate->interp);
+
+        {
+            py::subinterpreter_scoped_activate activate(sub);
+            REQUIRE(PyThreadState_Get()->interp == sub.state());
+            REQUIRE(&py::detail::get_internals() != main_internals);
+
+            auto m = py::module::import("widget_module");
+            REQUIRE_FALSE(py::hasattr(m, "extension_module_tag"));
+            REQUIRE(m.attr("add")(2, 3).cast<int>() == 5);
+
+            // Exception translation uses the internals of the sub-interpreter.
+            REQUIRE_THROWS_WITH(py::module::import("throw_exception"), "ImportError: C++ Error");
+            // ... including the exception types created by `register_exception`
+            py::exec(R"(
+                import widget_module
+                try:
+                    widget_module.throw_widget_error()
+                except widget_module.WidgetError:
+                    caught = True
+            )");
+            REQUIRE(py::globals()["caught"].cast<bool>());
+
+            // Releasing and reacquiring the GIL stays within the sub-interpreter.
+            {
+                py::gil_scoped_release release;
+                py::gil_scoped_acquire acquire;
+                REQUIRE(PyThreadState_Get()->interp == sub.state());
+            }
+            py::exec("sub_tag = 'sub'");
+        }
+        REQUIRE(PyThreadState_Get() == main_tstate);
+        REQUIRE(&py::detail::get_internals() == main_internals);
+        REQUIRE_FALSE(py::globals().contains("sub_tag"));
+
+        // Activating the sub-interpreter again finds its state unchanged.
+        {
+            py::subinterpreter_scoped_activate activate(sub);
+            REQUIRE(py::globals()["sub_tag"].cast<std::string>() == "sub");
+        }
+    }
+    REQUIRE(PyThreadState_Get() == main_tstate);
+    REQUIRE(py::module::import("widget_module").attr("extension_module_tag").cast<std::string>() == "main");
+}
+
+TEST_CASE("Subinterpreters in threads") {
+    constexpr auto num_threads = 4;
+    constexpr auto num_iterations = 50;
+    std::vector<py::subinterpreter> subs(num_threads);
+
+    {
+        py::gil_scoped_release gil_release{};
+
+        auto threads = std::vector<std::thread>();
+        for (auto i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&subs, i]() {
+                py::subinterpreter_scoped_activate activate(subs[(size_t) i]);
+                auto m = py::module::import("widget_module");
+                py::exec("count = 0");
+                for (auto j = 0; j < num_iterations; ++j) {
+                    py::gil_scoped_release release;
+                    py::gil_scoped_acquire acquire;
+                    py::globals()["count"] = m.attr("add")(py::globals()["count"], 1);
+                }
+            });
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    for (auto &sub : subs) {
+        py::subinterpreter_scoped_activate activate(sub);
+        REQUIRE(py::globals()["count"].cast<int>() == num_iterations);
+    }
+    REQUIRE_FALSE(py::globals().contains("count"));
 }
 
 TEST_CASE("Execution frame") {
@@ -216,3 +330,70 @@ TEST_CASE("Threads") {
 
     REQUIRE(locals["count"].cast<int>() == num_threads);
 }
+
+TEST_CASE("Interpreter executor") {
+    static_assert(!std::is_copy_constructible<py::interpreter_executor>::value, "");
+
+    REQUIRE_THROWS_WITH(py::interpreter_executor(0), Catch::Contains("at least one worker"));
+
+    py::interpreter_executor executor(2, 8);
+    REQUIRE(executor.num_threads() == 2);
+
+    // Jobs may be submitted (and waited for) while this thread holds the GIL, as long as it is
+    // released before waiting.
+    auto answer = executor.submit([]() {
+        return py::module::import("widget_module").attr("add")(40, 2).cast<int>();
+    });
+    auto error = executor.submit([]() { py::exec("raise ValueError('from a worker')"); });
+    {
+        py::gil_scoped_release release;
+        REQUIRE(answer.get() == 42);
+        REQUIRE_THROWS_WITH(error.get(), Catch::Contains("ValueError: from a worker"));
+    }
+    // Jobs are counted before their futures become ready
+    REQUIRE(executor.stats().completed == 2);
+
+    // Submission from many threads without the GIL
+    constexpr auto num_threads = 4;
+    constexpr auto num_jobs = 250;
+    auto locals = py::dict("count"_a=0);
+    {
+        py::gil_scoped_release release;
+        auto threads = std::vector<std::thread>();
+        for (auto i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&]() {
+                auto futures = std::vector<std::future<void>>();
+                for (auto j = 0; j < num_jobs; ++j) {
+                    futures.push_back(executor.submit([&locals]() {
+                        locals["count"] = locals["count"].cast<int>() + 1;
+                    }));
+                }
+                for (auto &f : futures)
+                    f.get();
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+    REQUIRE(locals["count"].cast<int>() == num_threads * num_jobs);
+
+    auto stats = executor.stats();
+    REQUIRE(stats.submitted == 2 + num_threads * num_jobs);
+    REQUIRE(stats.completed == stats.submitted);
+    REQUIRE(stats.queue_depth == 0);
+    REQUIRE(stats.max_queue_depth >= 1);
+    REQUIRE(stats.batches >= stats.submitted / 8);
+    REQUIRE(stats.batches <= stats.submitted);
+    REQUIRE(stats.max_wait <= stats.total_wait);
+
+    // Pending jobs are run when the executor is destroyed (with or without the GIL held)
+    auto ran = std::make_shared<bool>(false);
+    {
+        py::interpreter_executor short_lived;
+        short_lived.submit([ran]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            *ran = py::globals().contains("__builtins__");
+        });
+    }
+    REQUIRE(*ran);
+}
@@ -127,3 +127,52 @@ def test_enum_to_int():
     test_enum_to_uint(ClassWithUnscopedEnum.EMode.EFirstMode)
     test_enum_to_long_long(Flags.Read)
     test_enum_to_long_long(ClassWithUnscopedEnum.EMode.EFirstMode)
+
+
+def test_enum_members():
+    from pybind11_tests import UnscopedEnum, ScopedEnum, ClassWithUnscopedEnum
+
+    # Casting a value returns the interned member object
+    f = ClassWithUnscopedEnum.test_function
+    first = ClassWithUnscopedEnum.EFirstMode
+    assert f(first) is first
+    assert f(ClassWithUnscopedEnum.ESecondMode) is ClassWithUnscopedEnum.ESecondMode
+
+    # Values without a member are still representable
+    assert repr(UnscopedEnum(5)) == "UnscopedEnum.???"
+    assert UnscopedEnum(5) == 5
+    assert UnscopedEnum(2) == UnscopedEnum.ETwo
+    assert UnscopedEnum(2) is not UnscopedEnum.ETwo
+
+    assert hash(UnscopedEnum.ETwo) == hash(2)
+    assert hash(ScopedEnum.Three) == hash(3)
+    assert not (UnscopedEnum.EOne == None)  # noqa: E711
+    assert UnscopedEnum.EOne != None  # noqa: E711
+    assert ScopedEnum.Two != None  # noqa: E711
+
+    # Comparisons are implemented as native slots
+    assert type(UnscopedEnum.__dict__["__eq__"]).__name__ == "wrapper_descriptor"
+    with pytest.raises(TypeError):
+        assert ClassWithUnscopedEnum.EFirstMode < ClassWithUnscopedEnum.ESecondMode
+
+
+def test_enum_members_immutable():
+    from pybind11_tests import UnscopedEnum, ClassWithUnscopedEnum
+
+    # Member objects are shared by every cast, so they can't be re-initialized
+    with pytest.raises(TypeError) as excinfo:
+        UnscopedEnum.EOne.__init__(2)
+    assert str(excinfo.value) == "cannot re-initialize the enum member UnscopedEnum.EOne"
+    with pytest.raises(TypeError):
+        ClassWithUnscopedEnum.EFirstMode.__setstate__((2,))
+    assert int(UnscopedEnum.EOne) == 1
+    assert int(ClassWithUnscopedEnum.EFirstMode) == 1
+    assert ClassWithUnscopedEnum.test_function(ClassWithUnscopedEnum.EFirstMode) is \
+        ClassWithUnscopedEnum.EFirstMode
+
+    # Other instances can still be (re-)initialized
+    value = UnscopedEnum(1)
+    value.__init__(2)
+    assert value == UnscopedEnum.ETwo
+    value.__setstate__((1,))
+    assert value == UnscopedEnum.EOne
@@ -78,6 +78,38 @@ test_initializer eval([](py::module &m) {
         return false;
     });
 
+    m.def("test_compiled_code", []() {
+        auto code = py::compile("x * 2");
+        auto statements = py::compile<py::eval_statements>(R"(
+            y = x + 1
+            )");
+        int total = 0;
+        for (int i = 0; i < 3; i++) {
+            auto local = py::dict();
+            local["x"] = py::int_(i);
+            py::exec(statements, py::dict(), local);
+            total += py::eval(code, py::dict(), local).cast<int>() + local["y"].cast<int>();
+        }
+        return total == 12;
+    });
+
+    m.def("test_code_cache", []() {
+        py::code_cache cache(2);
+        auto local = py::dict();
+        local["x"] = py::int_(3);
+        py::list results;
+        for (auto expr : {"x + 1", "x * 2", "x + 1", "x - 1", "x * 2"})
+            results.append(cache.eval(py::str(expr), py::dict(), local));
+        cache.exec(R"(
+            z = x
+            )", py::dict(), local);
+        cache.exec(R"(
+            z = x
+            )", py::dict(), local);
+        return py::make_tuple(results, local["z"], cache.hits(), cache.misses(),
+                              cache.evictions(), cache.size());
+    });
+
     m.def("test_eval_file_failure", []() {
         try {
             py::eval_file("non-existing file");
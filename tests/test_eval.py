@@ -17,3 +17,14 @@ def test_evals(capture):
 
     assert test_eval_failure()
     assert test_eval_file_failure()
+
+
+def test_compiled_code():
+    from pybind11_tests import test_compiled_code, test_code_cache
+
+    assert test_compiled_code()
+
+    results, z, hits, misses, evictions, size = test_code_cache()
+    assert results == [4, 6, 4, 2, 6]
+    assert z == 3
+    assert (hits, misses, evictions, size) == (2, 5, 3, 2)
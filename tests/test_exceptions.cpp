@@ -58,6 +58,16 @@ class MyException5_1 : public MyException5 {
     using MyException5::MyException5;
 };
 
+// Translators for these are registered derived-first, so the base translator takes precedence
+class MyException6 : public std::runtime_error {
+public:
+    explicit MyException6(const std::string &what) : std::runtime_error(what) {}
+};
+
+class MyException6_1 : public MyException6 {
+    using MyException6::MyException6;
+};
+
 void throws1() {
     throw MyException("this error should go to a custom type");
 }
@@ -151,12 +161,18 @@ test_initializer custom_exceptions([](py::module &m) {
     // A slightly more complicated one that declares MyException5_1 as a subclass of MyException5
     py::register_exception<MyException5_1>(m, "MyException5_1", ex5.ptr());
 
+    // The most recently registered matching translator wins, even if a more specific one exists
+    py::register_exception<MyException6_1>(m, "MyException6_1");
+    py::register_exception<MyException6>(m, "MyException6");
+
     m.def("throws1", &throws1);
     m.def("throws2", &throws2);
     m.def("throws3", &throws3);
     m.def("throws4", &throws4);
     m.def("throws5", &throws5);
     m.def("throws5_1", &throws5_1);
+    m.def("throws6", []() { throw MyException6("MyException6 base"); });
+    m.def("throws6_1", []() { throw MyException6_1("MyException6 subclass"); });
     m.def("throws_logic_error", &throws_logic_error);
     m.def("exception_matches", &exception_matches);
 
@@ -189,4 +205,18 @@ test_initializer custom_exceptions([](py::module &m) {
         }
         return false;
     });
+
+    // test_error_result
+    m.def("error_result", [](int i) -> py::value_or_error<int> {
+        if (i < 0)
+            return py::error_result(PyExc_IndexError);
+        if (i == 0)
+            return py::error_result(PyExc_KeyError, "zero is not allowed");
+        return 2 * i;
+    });
+    m.def("error_result_str", [](bool fail) -> py::value_or_error<std::string> {
+        if (fail)
+            return py::error_result(PyExc_ValueError, "no string for you");
+        return std::string("a string");
+    });
 });
@@ -85,3 +85,44 @@ def test_custom(msg):
         except MyException5_1:
             raise RuntimeError("Exception error: caught child from parent")
     assert msg(excinfo.value) == "this is a helper-defined translated exception"
+
+
+def test_error_result(msg):
+    from pybind11_tests import error_result, error_result_str
+
+    assert error_result(21) == 42
+    with pytest.raises(IndexError) as excinfo:
+        error_result(-1)
+    assert msg(excinfo.value) == ""
+    with pytest.raises(KeyError) as excinfo:
+        error_result(0)
+    assert msg(excinfo.value) == "'zero is not allowed'"
+
+    assert error_result_str(False) == "a string"
+    with pytest.raises(ValueError) as excinfo:
+        error_result_str(True)
+    assert msg(excinfo.value) == "no string for you"
+
+
+def test_typed_translator_order(msg):
+    from pybind11_tests import (MyException6, MyException6_1, throws6, throws6_1,
+                                throws_logic_error, throws5_1, MyException5_1)
+
+    # Repeated throws exercise the cached translator resolution
+    for _ in range(3):
+        with pytest.raises(MyException6) as excinfo:
+            throws6()
+        assert msg(excinfo.value) == "MyException6 base"
+
+        # The base class translator was registered last, so it also handles the subclass
+        with pytest.raises(MyException6) as excinfo:
+            throws6_1()
+        assert msg(excinfo.value) == "MyException6 subclass"
+        assert not isinstance(excinfo.value, MyException6_1)
+
+        with pytest.raises(MyException5_1):
+            throws5_1()
+
+        with pytest.raises(RuntimeError) as excinfo:
+            throws_logic_error()
+        assert msg(excinfo.value) == "this error should fall through to the standard handler"
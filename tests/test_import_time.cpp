@@ -0,0 +1,48 @@
+/*
+    tests/test_import_time.cpp -- cost of registering functions at import time
+
+    Copyright (c) 2017 Wenzel Jakob <wenzel.jakob@epfl.ch>
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#include "pybind11_tests.h"
+
+TEST_SUBMODULE(import_time, m) {
+    // Registers `n` overloaded functions with keyword and default arguments in a new module, which
+    // is what importing a large extension module mostly consists of. With `eager`, the docstring is
+    // generated after every overload, as registration used to do before docstrings became lazy.
+    m.def("bind_functions", [](int n, bool signatures, bool eager) {
+        py::options options;
+        if (!signatures)
+            options.disable_function_signatures();
+
+        py::module bench("bench");
+        for (int i = 0; i < n; ++i) {
+            auto name = "f" + std::to_string(i);
+            bench.def(name.c_str(), [](int x, double y) { return x + y; },
+                      py::arg("x"), py::arg("y") = 1.5);
+            if (eager)
+                bench.attr(name.c_str()).attr("__doc__").cast<std::string>();
+            bench.def(name.c_str(), [](const std::string &s) { return s; }, "Echo a string");
+            if (eager)
+                bench.attr(name.c_str()).attr("__doc__").cast<std::string>();
+        }
+        return bench;
+    }, py::arg("n"), py::arg("signatures") = true, py::arg("eager") = false);
+
+    m.def("add_overload", [](py::module bench, const char *name) {
+        bench.def(name, [](int, int, int) { return 3; });
+    });
+
+    // Whether the docstring and the signatures of a function's overloads have been generated yet
+    m.def("docstring_state", [](py::function f) {
+        auto rec = (py::detail::function_record *) py::reinterpret_borrow<py::capsule>(
+            PyCFunction_GET_SELF(f.cpp_function().ptr()));
+        py::list signatures;
+        for (auto it = rec; it; it = it->next)
+            signatures.append(it->signature != nullptr);
+        return py::make_tuple(rec->def->ml_doc != nullptr, signatures);
+    });
+}
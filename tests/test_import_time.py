@@ -0,0 +1,65 @@
+import pytest
+import timeit
+
+from pybind11_tests import import_time as m
+
+
+def test_lazy_signatures(msg):
+    bench = m.bind_functions(2, signatures=False)
+    assert bench.f0(1) == 2.5
+    assert bench.f1("x") == "x"
+    assert bench.f0.__doc__ == "Echo a string"
+
+    # The signature is still generated for error messages
+    with pytest.raises(TypeError) as excinfo:
+        bench.f1(None)
+    assert msg(excinfo.value) == """
+        f1(): incompatible function arguments. The following argument types are supported:
+            1. (x: int, y: float=1.5) -> float
+            2. (arg0: str) -> str
+
+        Invoked with: None
+    """
+
+    bench = m.bind_functions(1)
+    assert bench.f0.__doc__ == """f0(*args, **kwargs)
+Overloaded function.
+
+1. f0(x: int, y: float=1.5) -> float
+
+2. f0(arg0: str) -> str
+
+Echo a string
+"""
+
+
+def test_lazy_docstrings():
+    bench = m.bind_functions(3)
+    assert type(bench.f0).__name__ == "pybind11_builtin_function"
+
+    # Registration generates neither the docstrings nor the signatures
+    assert m.docstring_state(bench.f0) == (False, [False, False])
+    assert bench.f0.__doc__.startswith("f0(*args, **kwargs)")
+    assert m.docstring_state(bench.f0) == (True, [True, True])
+    assert m.docstring_state(bench.f1) == (False, [False, False])
+
+    # Adding an overload discards the cached docstring (but not the cached signatures)
+    m.add_overload(bench, "f0")
+    assert m.docstring_state(bench.f0) == (False, [True, True, False])
+    assert bench.f0(1, 2, 3) == 3
+    assert "\n3. f0(arg0: int, arg1: int, arg2: int) -> int\n" in bench.f0.__doc__
+    assert m.docstring_state(bench.f0) == (True, [True, True, True])
+    assert bench.f1.__doc__ == bench.f2.__doc__.replace("f2", "f1")
+
+
+def test_import_time_benchmark():
+    """Compares the cost of registering functions with lazy docstrings and signatures against
+    generating them eagerly after every overload; run with `-s` to see the timings"""
+    n = 2000
+
+    def best_of(eager):
+        return min(timeit.repeat(lambda: m.bind_functions(n, eager=eager), number=1, repeat=3))
+
+    eager, lazy = best_of(True), best_of(False)
+    print("\nRegistering {} overloaded functions: {:.1f} ms with eager signatures, {:.1f} ms with "
+          "lazy ones ({:.1f}x faster)".format(n, eager * 1e3, lazy * 1e3, eager / lazy))
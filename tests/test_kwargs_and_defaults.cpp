@@ -82,6 +82,15 @@ test_initializer arg_keywords_and_defaults([](py::module &m) {
     m.def("mixed_plus_args_kwargs_defaults", &mixed_plus_args_kwargs,
             py::arg("i") = 1, py::arg("j") = 3.14159);
 
+    // Many keyword arguments, matched through the interned-name table
+    m.def("kw_many", [](int a, int b, int c, int d, int e, int f, int g, int h) {
+        return std::vector<int>{a, b, c, d, e, f, g, h};
+    }, py::arg("a"), py::arg("b") = 2, py::arg("c") = 3, py::arg("d") = 4, py::arg("e") = 5,
+       py::arg("f") = 6, py::arg("g") = 7, py::arg("h") = 8);
+    m.def("kw_many_kwargs", [](int a, int b, py::kwargs kwargs) {
+        return py::make_tuple(a, b, kwargs);
+    }, py::arg("a"), py::arg("b") = 2);
+
     // Uncomment these to test that the static_assert is indeed working:
 //    m.def("bad_args1", &bad_args1);
 //    m.def("bad_args2", &bad_args2);
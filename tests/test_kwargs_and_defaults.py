@@ -106,3 +106,38 @@ def test_mixed_args_and_kwargs(msg):
 
         Invoked with: 1, 2; kwargs: j=1
     """  # noqa: E501 line too long
+
+
+def test_many_keywords():
+    try:
+        from sys import intern
+    except ImportError:
+        pass  # Python 2: `intern` is a builtin
+    from pybind11_tests import kw_func4, kw_many, kw_many_kwargs
+
+    assert kw_many(1) == [1, 2, 3, 4, 5, 6, 7, 8]
+    assert kw_many(h=-8, a=-1, e=-5) == [-1, 2, 3, 4, -5, 6, 7, -8]
+    assert kw_many(1, 20, 30, g=70, d=40) == [1, 20, 30, 40, 5, 6, 70, 8]
+    # Keys which aren't interned strings are matched by value (single-character strings are always
+    # shared by CPython, so the runtime key needs a longer name)
+    key = "".join(["my", "List"])
+    assert intern(key) is not key
+    assert kw_func4(**{key: [1, 2]}) == "{1 2}"
+    # ... including unicode keys on Python 2
+    assert kw_func4(**{u"".join([u"my", u"List"]): [3]}) == "{3}"
+
+    with pytest.raises(TypeError):
+        kw_many(1, 2, b=3)
+    with pytest.raises(TypeError):
+        kw_many(1, z=26)
+    with pytest.raises(TypeError):
+        kw_many(b=2)
+
+    assert kw_many_kwargs(1) == (1, 2, {})
+    assert kw_many_kwargs(b=3, a=4, z=5) == (4, 3, {'z': 5})
+    extra = "".join(["ex", "tra"])
+    assert intern(extra) is not extra
+    assert kw_many_kwargs(a=1, **{"".join(["b"]): 6, extra: 7}) == (1, 6, {'extra': 7})
+    kwargs = {'a': 1, 'x': 2}
+    assert kw_many_kwargs(**kwargs) == (1, 2, {'x': 2})
+    assert kwargs == {'a': 1, 'x': 2}
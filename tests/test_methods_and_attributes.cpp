@@ -110,6 +110,14 @@ public:
 
 class CppDerivedDynamicClass : public DynamicClass { };
 
+class FixedAttrsClass {
+public:
+    FixedAttrsClass() { print_default_created(this); }
+    ~FixedAttrsClass() { print_destroyed(this); }
+};
+
+class CppDerivedFixedAttrsClass : public FixedAttrsClass { };
+
 // py::arg/py::arg_v testing: these arguments just record their argument when invoked
 class ArgInspector1 { public: std::string arg = "(default arg inspector 1)"; };
 class ArgInspector2 { public: std::string arg = "(default arg inspector 2)"; };
@@ -194,6 +202,18 @@ public:
     double sum() const { return rw_value + ro_value; }
 };
 
+// Fields bound with native member descriptors, including one in a base class at a non-zero offset
+struct NativeMemberPoint { double x = 0, y = 0; };
+struct NativeMemberPadding { char padding[24] = {}; };
+struct NativeMemberBase { int base_value = 3; };
+struct NativeMembers : NativeMemberPadding, NativeMemberBase {
+    int i = 1;
+    double d = 2.5;
+    bool b = true;
+    NativeMemberPoint p;
+    std::string s = "str";
+};
+
 test_initializer methods_and_attributes([](py::module &m) {
     py::class_<ExampleMandA> emna(m, "ExampleMandA");
     emna.def(py::init<>())
@@ -315,6 +335,13 @@ test_initializer methods_and_attributes([](py::module &m) {
 
     py::class_<CppDerivedDynamicClass, DynamicClass>(m, "CppDerivedDynamicClass")
         .def(py::init());
+
+    py::class_<FixedAttrsClass>(m, "FixedAttrsClass", py::fixed_attrs("a", "b"))
+        .def(py::init());
+
+    py::class_<CppDerivedFixedAttrsClass, FixedAttrsClass>(m, "CppDerivedFixedAttrsClass",
+                                                           py::fixed_attrs("c"), py::dynamic_attr())
+        .def(py::init());
 #endif
 
     // Test converting.  The ArgAlwaysConverts is just there to make the first no-conversion pass
@@ -399,4 +426,18 @@ test_initializer methods_and_attributes([](py::module &m) {
 
     using Adapted = decltype(py::method_adaptor<RegisteredDerived>(&RegisteredDerived::do_nothing));
     static_assert(std::is_same<Adapted, void (RegisteredDerived::*)() const>::value, "");
+
+    py::class_<NativeMemberPoint>(m, "NativeMemberPoint")
+        .def(py::init<>())
+        .def_readwrite("x", &NativeMemberPoint::x)
+        .def_readwrite("y", &NativeMemberPoint::y);
+    py::class_<NativeMembers>(m, "NativeMembers")
+        .def(py::init<>())
+        .def_readwrite("i", &NativeMembers::i)
+        .def_readwrite("d", &NativeMembers::d, "A double field")
+        .def_readonly("b", &NativeMembers::b)
+        .def_readwrite("p", &NativeMembers::p)
+        .def_readwrite("s", &NativeMembers::s)
+        .def_readwrite("base_value", &NativeMembers::base_value)
+        .def("sum", [](const NativeMembers &n) { return n.i + n.d + n.base_value + n.p.x + n.p.y; });
 });
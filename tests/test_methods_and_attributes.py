@@ -303,6 +303,78 @@ def test_cyclic_gc():
     assert cstats.alive() == 0
 
 
+@pytest.unsupported_on_pypy
+def test_lazy_gc_tracking():
+    import gc
+    from pybind11_tests import DynamicClass
+
+    instance = DynamicClass()
+    assert not gc.is_tracked(instance)
+    instance.foo = 1
+    assert gc.is_tracked(instance)
+
+    instance = DynamicClass()
+    assert instance.__dict__ == {}
+    assert gc.is_tracked(instance)
+
+    class PythonDerivedDynamicClass(DynamicClass):
+        pass
+
+    assert gc.is_tracked(PythonDerivedDynamicClass())
+
+
+@pytest.unsupported_on_pypy
+def test_fixed_attributes():
+    import gc
+    from pybind11_tests import FixedAttrsClass, CppDerivedFixedAttrsClass
+
+    instance = FixedAttrsClass()
+    assert not gc.is_tracked(instance)
+    assert not hasattr(instance, "a")
+    assert not hasattr(instance, "__dict__")
+    instance.a = [1]
+    instance.b = "b"
+    assert gc.is_tracked(instance)
+    assert instance.a == [1] and instance.b == "b"
+    del instance.a
+    assert not hasattr(instance, "a")
+    with pytest.raises(AttributeError):
+        instance.c = 3
+
+    derived = CppDerivedFixedAttrsClass()
+    derived.a, derived.c, derived.d = 1, 3, 4
+    assert (derived.a, derived.c, derived.d) == (1, 3, 4)
+    assert derived.__dict__ == {"d": 4}
+
+    class PythonDerivedFixedAttrsClass(FixedAttrsClass):
+        __slots__ = ("z",)
+
+    py_derived = PythonDerivedFixedAttrsClass()
+    py_derived.b, py_derived.z = 2, 26
+    assert (py_derived.b, py_derived.z) == (2, 26)
+
+    cstats = ConstructorStats.get(FixedAttrsClass)
+    assert cstats.alive() == 3
+    del instance, derived, py_derived
+    assert cstats.alive() == 0
+
+    # Reference cycles through fixed attributes are collected
+    i1, i2 = FixedAttrsClass(), CppDerivedFixedAttrsClass()
+    i1.a = i2
+    i2.c = i1
+    del i1, i2
+    pytest.gc_collect()
+    assert cstats.alive() == 0
+
+    # Also when the slot is set through the descriptor, bypassing `setattr`
+    instance = FixedAttrsClass()
+    FixedAttrsClass.a.__set__(instance, instance)
+    assert gc.is_tracked(instance)
+    del instance
+    pytest.gc_collect()
+    assert cstats.alive() == 0
+
+
 def test_noconvert_args(msg):
     import pybind11_tests as m
 
@@ -477,3 +549,45 @@ def test_unregistered_base_implementations():
     assert a.rw_value_prop == 49
     a.increase_value()
     assert a.ro_value_prop == 1.75
+
+
+@pytest.unsupported_on_pypy
+def test_native_members():
+    from pybind11_tests import NativeMembers, NativeMemberPoint
+
+    def descr(name):
+        return type(NativeMembers.__dict__[name]).__name__
+
+    assert descr("i") == descr("d") == descr("b") == descr("p") == "pybind11_member"
+    assert descr("s") == "property"
+    assert NativeMembers.d.__doc__ == "A double field"
+
+    n = NativeMembers()
+    assert (n.i, n.d, n.b, n.s, n.base_value) == (1, 2.5, True, "str", 3)
+    n.i, n.d, n.base_value = 10, 0.5, 30
+    assert n.sum() == 40.5
+
+    # Registered POD fields are returned by reference and keep their parent alive
+    p = n.p
+    p.x = 4
+    assert n.p.x == 4 and n.sum() == 44.5
+    del n
+    assert p.x == 4
+
+    n = NativeMembers()
+    point = NativeMemberPoint()
+    point.y = 7
+    n.p = point
+    assert n.p.y == 7
+
+    with pytest.raises(AttributeError):
+        n.b = False
+    with pytest.raises(AttributeError):
+        del n.i
+    with pytest.raises(TypeError) as excinfo:
+        n.i = "not an int"
+    assert str(excinfo.value) == "Unable to convert 'str' object to C++ type 'int'"
+    with pytest.raises(TypeError):
+        n.p = None
+    with pytest.raises(TypeError):
+        NativeMembers.__dict__["i"].__get__(NativeMemberPoint())
@@ -104,6 +104,7 @@ test_initializer multiple_inheritance_nonexplicit([](py::module &m) {
 
     m.def("bar_base2a", [](Base2a *b) { return b->bar(); });
     m.def("bar_base2a_sharedptr", [](std::shared_ptr<Base2a> b) { return b->bar(); });
+    m.def("bar_base2a_sharedptr_ref", [](const std::shared_ptr<Base2a> &b) { return b->bar(); });
 });
 
 // Issue #801: invalid casting to derived type with MI bases
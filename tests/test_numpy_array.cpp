@@ -11,6 +11,7 @@
 
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <pybind11/complex_numpy.h>
 
 #include <cstdint>
 
@@ -297,4 +298,26 @@ test_initializer numpy_array([](py::module &m) {
         std::fill(a.mutable_data(), a.mutable_data() + a.size(), 42.);
         return a;
     });
+
+    // test_complex_vectors
+    sm.def("complex_vector", [](size_t n) {
+        std::vector<std::complex<float>> v;
+        for (size_t i = 0; i < n; ++i)
+            v.emplace_back((float) i, -(float) i);
+        return v;
+    });
+    sm.def("complex_vector_scale", [](std::vector<std::complex<double>> v, double factor) {
+        for (auto &c : v) c *= factor;
+        return v;
+    });
+    sm.def("complex_vector_sum", [](const std::vector<std::complex<float>> &v) {
+        std::complex<float> sum;
+        for (auto &c : v) sum += c;
+        return sum;
+    });
+    sm.def("complex_vector_sum_noconvert", [](const std::vector<std::complex<float>> &v) {
+        std::complex<float> sum;
+        for (auto &c : v) sum += c;
+        return sum;
+    }, py::arg().noconvert());
 });
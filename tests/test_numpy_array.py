@@ -248,6 +248,10 @@ def test_isinstance():
 
     assert isinstance_untyped(np.array([1, 2, 3]), "not an array")
     assert isinstance_typed(np.array([1.0, 2.0, 3.0]))
+    # Distinct but equivalent descriptor objects also match; other byte orders don't
+    assert isinstance_typed(np.zeros(3, dtype=np.dtype('f8').newbyteorder('=')))
+    assert isinstance_typed(np.zeros(6)[::2])
+    assert not isinstance_typed(np.zeros(3, dtype=np.dtype('f8').newbyteorder('S')))
 
 
 def test_constructors():
@@ -433,3 +437,39 @@ def test_array_create_and_resize(msg):
     a = create_and_resize(2)
     assert(a.size == 4)
     assert(np.all(a == 42.))
+
+
+def test_complex_vectors():
+    from pybind11_tests.array import complex_vector, complex_vector_scale, complex_vector_sum
+
+    a = complex_vector(4)
+    assert a.dtype == np.complex64
+    assert np.all(a == [0, 1 - 1j, 2 - 2j, 3 - 3j])
+    assert complex_vector(0).shape == (0,)
+
+    b = complex_vector_scale(a, 2)
+    assert b.dtype == np.complex128
+    assert np.all(b == [0, 2 - 2j, 4 - 4j, 6 - 6j])
+    assert np.all(complex_vector_scale(b[::2], 0.5) == [0, 2 - 2j])
+
+    assert complex_vector_sum(b) == 12 - 12j
+    # Non-array sequences keep going through the element-wise conversion
+    assert complex_vector_sum([1j, 2, 3 + 1j]) == 5 + 2j
+    assert complex_vector_sum(np.array([1.5, 2.5])) == 4
+
+    with pytest.raises(TypeError):
+        complex_vector_sum(np.zeros((2, 2), dtype=np.complex64))
+    assert complex_vector_scale.__doc__.startswith(
+        "complex_vector_scale(arg0: numpy.ndarray[complex128], arg1: float) -> numpy.ndarray[complex128]")
+
+
+def test_complex_vectors_noconvert():
+    from pybind11_tests.array import complex_vector_sum_noconvert as f
+
+    a = np.array([1 + 1j, 2, 3 - 2j], dtype=np.complex64)
+    assert f(a) == 6 - 1j
+
+    # Other precisions and non-contiguous arrays need a conversion
+    for arr in [a.astype(np.complex128), a[::2]]:
+        with pytest.raises(TypeError):
+            f(arr)
@@ -9,6 +9,7 @@
 
 #include "pybind11_tests.h"
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 
 #ifdef __GNUC__
 #define PYBIND11_PACKED(cls) cls __attribute__((__packed__))
@@ -467,6 +468,23 @@ test_initializer numpy_dtypes([](py::module &m) {
     m.def("f_packed", [](PackedStruct s) { return s.uint_ * 10; });
     m.def("f_nested", [](NestedStruct s) { return s.a.uint_ * 10; });
     m.def("register_dtype", []() { PYBIND11_NUMPY_DTYPE(SimpleStruct, bool_, uint_, float_, ldbl_); });
+
+    // test_vector_of_records
+    m.def("vector_rec_simple", [](size_t n) {
+        py::structured_vector<SimpleStruct> v(n);
+        for (size_t i = 0; i < n; ++i)
+            v[i] = SimpleStruct{i % 2 == 0, (uint32_t) i, 1.5f * (float) i, -2.5L * (long double) i};
+        return v;
+    });
+    m.def("roundtrip_rec_simple", [](py::structured_vector<SimpleStruct> v) {
+        for (auto &s : v)
+            ++s.uint_;
+        return v;
+    });
+    m.def("roundtrip_rec_simple_noconvert", [](py::structured_vector<SimpleStruct> v) { return v; },
+          py::arg().noconvert());
+    // Plain vectors are still converted element by element
+    m.def("vector_rec_simple_list", [](std::vector<SimpleStruct> v) { return v.size(); });
 });
 
 #undef PYBIND11_PACKED
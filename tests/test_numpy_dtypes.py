@@ -319,3 +319,49 @@ def test_register_dtype():
 def test_compare_buffer_info():
     from pybind11_tests import compare_buffer_info
     assert all(compare_buffer_info())
+
+
+def test_vector_of_records():
+    arr = m.vector_rec_simple(4)
+    assert isinstance(arr, np.ndarray)
+    assert arr.dtype.names == ('bool_', 'uint_', 'float_', 'ldbl_')
+    assert arr['bool_'].tolist() == [True, False, True, False]
+    assert arr['uint_'].tolist() == [0, 1, 2, 3]
+    assert arr['float_'].tolist() == [0, 1.5, 3, 4.5]
+    assert arr['ldbl_'].tolist() == [0, -2.5, -5, -7.5]
+    assert m.vector_rec_simple(0).shape == (0,)
+
+    # Same dtype: contiguous or strided
+    assert m.roundtrip_rec_simple(arr)['uint_'].tolist() == [1, 2, 3, 4]
+    assert m.roundtrip_rec_simple(arr[::-2])['uint_'].tolist() == [4, 2]
+    assert m.roundtrip_rec_simple_noconvert(arr)['uint_'].tolist() == [0, 1, 2, 3]
+
+    # Fields in a different order, with padding and an extra field
+    reordered = np.zeros(3, dtype=[('ldbl_', 'g'), ('extra', 'i8'), ('float_', 'f4'),
+                                   ('uint_', 'u4'), ('bool_', '?')])
+    reordered['uint_'] = [5, 6, 7]
+    reordered['float_'] = [0.5, 1, 2]
+    reordered['ldbl_'] = [-1, -2, -3]
+    reordered['bool_'] = [False, True, False]
+    back = m.roundtrip_rec_simple(reordered)
+    assert back['uint_'].tolist() == [6, 7, 8]
+    assert back['float_'].tolist() == [0.5, 1, 2]
+    assert back['ldbl_'].tolist() == [-1, -2, -3]
+    assert back['bool_'].tolist() == [False, True, False]
+    with pytest.raises(TypeError):
+        m.roundtrip_rec_simple_noconvert(reordered)
+
+    # Missing fields or fields of a different type can't be converted
+    with pytest.raises(TypeError):
+        m.roundtrip_rec_simple(np.zeros(2, dtype=[('uint_', 'u4')]))
+    with pytest.raises(TypeError):
+        m.roundtrip_rec_simple(reordered.astype([('ldbl_', 'g'), ('extra', 'i8'), ('float_', 'f8'),
+                                                 ('uint_', 'u4'), ('bool_', '?')]))
+
+    # Sequences of records are still converted element by element
+    assert m.roundtrip_rec_simple(list(arr))['uint_'].tolist() == [1, 2, 3, 4]
+
+    # Plain std::vector arguments keep their element-wise conversion
+    assert m.vector_rec_simple_list(list(arr)) == 4
+    assert m.vector_rec_simple_list(arr) == 4
+    assert "numpy.ndarray[" in m.roundtrip_rec_simple.__doc__
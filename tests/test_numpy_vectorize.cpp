@@ -45,6 +45,11 @@ test_initializer numpy_vectorize([](py::module &m) {
     // Vectorize a complex-valued function
     m.def("vectorized_func3", py::vectorize(my_func3));
 
+    // Complex kernel with a broadcast scalar argument
+    m.def("vectorized_mix", py::vectorize([](const std::complex<float> &sample, std::complex<float> gain) {
+        return sample * gain;
+    }));
+
     /// Numpy function which only accepts specific data types
     m.def("selective_func", [](py::array_t<int, py::array::c_style>) { return "Int branch taken."; });
     m.def("selective_func", [](py::array_t<float, py::array::c_style>) { return "Float branch taken."; });
@@ -11,6 +11,14 @@ def test_vectorize(capture):
 
     assert np.isclose(vectorized_func3(np.array(3 + 7j)), [6 + 14j])
 
+    from pybind11_tests import vectorized_mix
+    samples = np.array([[1 + 1j, 2], [-1j, 3 - 2j]], dtype=np.complex64)
+    mixed = vectorized_mix(samples, 2j)
+    assert mixed.dtype == np.complex64
+    assert np.allclose(mixed, samples * 2j)
+    assert np.allclose(vectorized_mix(samples.T, 1j), samples.T * 1j)
+    assert vectorized_mix(1 + 2j, 2) == 2 + 4j
+
     for f in [vectorized_func, vectorized_func2]:
         with capture:
             assert np.isclose(f(1, 2, 3), 6)
@@ -102,6 +110,25 @@ def test_vectorize(capture):
         """
 
 
+def test_broadcast_loop():
+    from pybind11_tests import vectorized_func, vectorized_is_trivial, trivial
+
+    # (N, 1) x (1, M): the longer, outer dimension becomes the inner loop
+    a = np.arange(1, 8, dtype='int32').reshape(7, 1)
+    b = np.array([[2, 3]], dtype='float32')
+    assert vectorized_is_trivial(a, b, 2) == trivial.non_trivial
+    result = vectorized_func(a, b, 2)
+    assert result.shape == (7, 2)
+    assert np.allclose(result, a * b * 2)
+
+    # Non-contiguous and reversed operands with dimensions of extent 1 mixed in
+    z = np.arange(60, dtype='float64').reshape(3, 4, 5)
+    for x in [z[:, ::-2, 1:], z[::2, :1, ::3], z.transpose(2, 0, 1)]:
+        y = np.arange(x.shape[-1], dtype='float32')[::-1]
+        assert np.allclose(vectorized_func(1, y, x), y * x)
+        assert np.allclose(vectorized_func(x[..., :1].astype('int32'), y, 3), x[..., :1] * y * 3)
+
+
 def test_type_selection():
     from pybind11_tests import selective_func
 
@@ -85,6 +85,25 @@ struct NestC {
     NestC& operator*=(int i) { value *= i; return *this; }
 };
 
+// Operators between two Amounts are evaluated through native number and comparison slots
+struct Amount {
+    long long value;
+    Amount(long long value) : value(value) { }
+    Amount operator+(const Amount &a) const { return value + a.value; }
+    Amount operator-(const Amount &a) const { return value - a.value; }
+    Amount operator+(long long v) const { return value + v; }
+    Amount operator/(const Amount &a) const {
+        if (a.value == 0) throw std::domain_error("division by zero");
+        return value / a.value;
+    }
+    Amount &operator+=(const Amount &a) { value += a.value; return *this; }
+    Amount operator-() const { return -value; }
+    bool operator==(const Amount &a) const { return value == a.value; }
+    bool operator!=(const Amount &a) const { return value != a.value; }
+    bool operator<(const Amount &a) const { return value < a.value; }
+    friend Amount operator-(long long v, const Amount &a) { return v - a.value; }
+};
+
 test_initializer operator_overloading([](py::module &pm) {
     auto m = pm.def_submodule("operators");
 
@@ -146,6 +165,20 @@ test_initializer operator_overloading([](py::module &pm) {
         .def(py::self *= int())
         .def_readwrite("b", &NestC::b);
 
+    py::class_<Amount>(m, "Amount")
+        .def(py::init<long long>())
+        .def_readonly("value", &Amount::value)
+        .def(py::self + py::self)
+        .def(py::self - py::self)
+        .def(py::self / py::self)
+        .def(py::self + (long long) 0)
+        .def((long long) 0 - py::self)
+        .def(py::self += py::self)
+        .def(-py::self)
+        .def(py::self == py::self)
+        .def(py::self != py::self)
+        .def(py::self < py::self);
+
     m.def("get_NestA", [](const NestA &a) { return a.value; });
     m.def("get_NestB", [](const NestB &b) { return b.value; });
     m.def("get_NestC", [](const NestC &c) { return c.value; });
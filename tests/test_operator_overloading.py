@@ -68,6 +68,54 @@ def test_operators_notimplemented():
     assert c1 + c2 == 12
 
 
+def test_native_operator_slots():
+    from pybind11_tests.operators import Amount
+
+    a, b = Amount(5), Amount(3)
+    assert (a + b).value == 8
+    assert (a - b).value == 2
+    assert (-a).value == -5
+    assert (a + 10).value == 15
+    assert (10 - a).value == 5
+    with pytest.raises(TypeError):
+        a + "x"
+    with pytest.raises(TypeError):
+        "x" - a
+    # Operands without any number slots
+    for other in [object(), [], [1]]:
+        with pytest.raises(TypeError):
+            a + other
+        with pytest.raises(TypeError):
+            a - other
+        with pytest.raises(TypeError):
+            other + a
+    with pytest.raises(ValueError) as excinfo:
+        a / Amount(0)
+    assert str(excinfo.value) == "division by zero"
+
+    c = a
+    a += b
+    assert a is c and a.value == 8
+
+    assert a == Amount(8) and a != b and not a == b
+    assert b < a and not a < b
+    assert a != "8" and not a == None  # noqa: E711
+    assert [x.value for x in sorted([Amount(2), Amount(-1), Amount(1)])] == [-1, 1, 2]
+
+    # Python subclasses go through the regular method lookup, including reflected methods
+    class Sub(Amount):
+        def __radd__(self, other):
+            return "radd"
+
+        def __neg__(self):
+            return "neg"
+
+    assert Amount(1) + Sub(2) == "radd"
+    assert (Sub(1) + Amount(2)).value == 3
+    assert -Sub(1) == "neg"
+    assert Sub(1) == Amount(1)
+
+
 def test_nested():
     """#328: first member in a class can't be used in operators"""
     from pybind11_tests.operators import NestA, NestB, NestC, get_NestA, get_NestB, get_NestC
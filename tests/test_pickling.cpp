@@ -32,6 +32,24 @@ public:
     int extra;
 };
 
+struct TrivialPoint {
+    double x = 0, y = 0;
+    int tag = 0;
+};
+
+class PickleableBuffer {
+public:
+    PickleableBuffer(ssize_t rows, ssize_t cols) : m_rows(rows), m_cols(cols), m_data((size_t) (rows * cols)) { }
+    float get(ssize_t i, ssize_t j) const { return m_data[(size_t) (i * m_cols + j)]; }
+    void set(ssize_t i, ssize_t j, float v) { m_data[(size_t) (i * m_cols + j)] = v; }
+    float *data() { return m_data.data(); }
+    ssize_t rows() const { return m_rows; }
+    ssize_t cols() const { return m_cols; }
+private:
+    ssize_t m_rows, m_cols;
+    std::vector<float> m_data;
+};
+
 test_initializer pickling([](py::module &m) {
     py::class_<Pickleable>(m, "Pickleable")
         .def(py::init<std::string>())
@@ -57,6 +75,31 @@ test_initializer pickling([](py::module &m) {
             p.setExtra2(t[2].cast<int>());
         });
 
+    // test_pickle_trivial
+    py::class_<TrivialPoint>(m, "TrivialPoint", py::pickle_trivial())
+        .def(py::init<>())
+        .def_readwrite("x", &TrivialPoint::x)
+        .def_readwrite("y", &TrivialPoint::y)
+        .def_readwrite("tag", &TrivialPoint::tag);
+
+    // test_pickle_buffer
+    py::class_<PickleableBuffer>(m, "PickleableBuffer", py::buffer_protocol())
+        .def(py::init<ssize_t, ssize_t>())
+        .def("get", &PickleableBuffer::get)
+        .def("set", &PickleableBuffer::set)
+        .def("data_address", [](PickleableBuffer &b) { return (uintptr_t) b.data(); })
+        .def_buffer([](PickleableBuffer &b) {
+            return py::buffer_info(b.data(), {b.rows(), b.cols()},
+                                   {sizeof(float) * b.cols(), sizeof(float)});
+        })
+        .def_pickle_buffer([](const py::buffer_info &info) {
+            if (info.format != py::format_descriptor<float>::format() || info.ndim != 2)
+                throw std::runtime_error("Incompatible buffer!");
+            PickleableBuffer b(info.shape[0], info.shape[1]);
+            std::memcpy(b.data(), info.ptr, sizeof(float) * (size_t) info.size);
+            return b;
+        });
+
 #if !defined(PYPY_VERSION)
     py::class_<PickleableWithDict>(m, "PickleableWithDict", py::dynamic_attr())
         .def(py::init<std::string>())
@@ -33,3 +33,55 @@ def test_roundtrip_with_dict():
     assert p2.value == p.value
     assert p2.extra == p.extra
     assert p2.dynamic == p.dynamic
+
+
+def test_pickle_trivial():
+    from pybind11_tests import TrivialPoint
+
+    p = TrivialPoint()
+    p.x, p.y, p.tag = 1.5, -2.25, 7
+
+    assert isinstance(p.__getstate__(), bytes)
+    for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+        p2 = pickle.loads(pickle.dumps(p, protocol))
+        assert (p2.x, p2.y, p2.tag) == (1.5, -2.25, 7)
+
+    with pytest.raises(ValueError) as excinfo:
+        TrivialPoint().__setstate__(b"too short")
+    assert "Invalid state" in str(excinfo.value)
+
+
+def make_pickleable_buffer():
+    from pybind11_tests import PickleableBuffer
+
+    b = PickleableBuffer(3, 4)
+    for i in range(3):
+        for j in range(4):
+            b.set(i, j, i * 10 + j)
+    return b
+
+
+def check_pickleable_buffer(b):
+    assert memoryview(b).shape == (3, 4)
+    assert [[b.get(i, j) for j in range(4)] for i in range(3)] == \
+        [[i * 10 + j for j in range(4)] for i in range(3)]
+
+
+def test_pickle_buffer():
+    b = make_pickleable_buffer()
+    for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+        check_pickleable_buffer(pickle.loads(pickle.dumps(b, protocol)))
+
+
+@pytest.mark.skipif(pickle.HIGHEST_PROTOCOL < 5, reason="requires pickle protocol 5")
+def test_pickle_buffer_out_of_band():
+    b = make_pickleable_buffer()
+
+    buffers = []
+    data = pickle.dumps(b, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 1
+    assert len(buffers[0].raw()) == 3 * 4 * 4
+
+    b2 = pickle.loads(data, buffers=buffers)
+    check_pickleable_buffer(b2)
+    assert b2.data_address() != b.data_address()
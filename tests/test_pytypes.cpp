@@ -163,6 +163,28 @@ TEST_SUBMODULE(pytypes, m) {
         return d;
     });
 
+    // test_interned
+    m.def("interned_accessors", [](py::object o) {
+        static const py::interned basic_attr("basic_attr");
+        auto d = py::dict();
+        d["attr(interned)"] = o.attr(basic_attr);
+        d["operator[interned]"] = o.attr("d"_id)["operator[object]"_id];
+        d["getattr"] = py::getattr(o, "basic_attr"_id);
+        d["getattr_default"] = py::getattr(o, "missing"_id, "default"_s);
+        d["hasattr"] = py::hasattr(o, basic_attr);
+        d["hasattr_missing"] = py::hasattr(o, "missing"_id);
+        py::setattr(o, "new_attr"_id, py::int_(5));
+        o.attr("d"_id)["new_item"_id] = 3;
+        d["contains"] = o.attr("d"_id).contains("new_item"_id);
+        return d;
+    });
+    m.def("interned_identity", []() {
+        // The static instance returns its remembered string on the second call
+        static const py::interned cached("some_interned_name");
+        return py::make_tuple("some_interned_name"_id, py::interned("some_interned_name"),
+                              cached, cached);
+    });
+
     // test_constructors
     m.def("default_constructors", []() {
         return py::dict(
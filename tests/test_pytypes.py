@@ -155,6 +155,34 @@ def test_accessors():
     assert d["var"] == 99
 
 
+def test_interned():
+    import sys
+
+    class TestObject:
+        basic_attr = 1
+        d = {"operator[object]": 2}
+
+    o = TestObject()
+    d = m.interned_accessors(o)
+    assert d == {
+        "attr(interned)": 1,
+        "operator[interned]": 2,
+        "getattr": 1,
+        "getattr_default": "default",
+        "hasattr": True,
+        "hasattr_missing": False,
+        "contains": True,
+    }
+    assert o.new_attr == 5
+    assert o.d["new_item"] == 3
+
+    a, b, c, d = m.interned_identity()
+    assert a == "some_interned_name"
+    assert a is b is c is d
+    sys_intern = getattr(sys, "intern", None) or intern  # noqa: F821 (builtin on Python 2)
+    assert a is sys_intern("some_interned_name")
+
+
 def test_constructors():
     """C++ default and converting constructors are equivalent to type calls in Python"""
     types = [str, bool, int, float, tuple, list, dict, set]
@@ -329,6 +329,11 @@ test_initializer smart_ptr_and_references([](py::module &pm) {
         .def(py::init<int>())
         .def("value", &ElementA::value);
 
+    // Holders taken by const reference refer to the instance's holder, other parameters get copies
+    m.def("holder_use_count", [](const std::shared_ptr<ElementBase> &e) { return e.use_count(); });
+    m.def("holder_copy_use_count", [](std::shared_ptr<ElementBase> e) { return e.use_count(); });
+    m.def("holder_reset", [](std::shared_ptr<ElementBase> &e) { e.reset(); return !e; });
+
     py::class_<ElementList, std::shared_ptr<ElementList>>(m, "ElementList")
         .def(py::init<>())
         .def("add", &ElementList::add)
@@ -112,7 +112,7 @@ def test_smart_ptr(capture):
     assert cstats.default_constructions == 30
     assert cstats.copy_constructions == 12
     # assert cstats.move_constructions >= 0 # Doesn't invoke any
-    assert cstats.copy_assignments == 30
+    assert cstats.copy_assignments == 0  # loading only copies holders into by-value parameters
     assert cstats.move_assignments == 0
 
 
@@ -236,6 +236,17 @@ def test_smart_ptr_from_default():
     assert "Unable to load a custom holder type from a default-holder instance" in str(excinfo)
 
 
+def test_shared_ptr_holder_loading():
+    from pybind11_tests import smart_ptr as m
+
+    e = m.ElementA(5)
+    assert m.holder_use_count(e) == 1
+    assert m.holder_copy_use_count(e) == 2
+    assert m.holder_reset(e)
+    assert e.value() == 5
+    assert m.holder_use_count(e) == 1
+
+
 def test_shared_ptr_gc():
     """#187: issue involving std::shared_ptr<> return value policy & garbage collection"""
     from pybind11_tests.smart_ptr import ElementList, ElementA
@@ -54,6 +54,16 @@ TEST_SUBMODULE(stl, m) {
     m.def("load_map", [](const std::map<std::string, std::string> &map) {
         return map.at("key") == "value" && map.at("key2") == "value2";
     });
+    m.def("load_unordered_map", [](const std::unordered_map<std::string, int> &map) {
+        return map.size() == 3 && map.at("a") == 1 && map.at("c") == 3;
+    });
+    // Equal string keys of the maps in a list are converted to the same Python string
+    m.def("cast_map_rows", [](int rows) {
+        std::vector<std::map<std::string, int>> v;
+        for (int i = 0; i < rows; i++)
+            v.push_back({{"id", i}, {"value", 10 * i}});
+        return v;
+    });
 
     // test_set
     m.def("cast_set", []() { return std::set<std::string>{"key1", "key2"}; });
@@ -165,6 +175,8 @@ TEST_SUBMODULE(stl, m) {
         const char *operator()(std::string) { return "std::string"; }
         const char *operator()(double) { return "double"; }
         const char *operator()(std::nullptr_t) { return "std::nullptr_t"; }
+        const char *operator()(bool) { return "bool"; }
+        const char *operator()(const UserType &) { return "UserType"; }
     };
 
     m.def("load_variant", [](std::variant<int, std::string, double, std::nullptr_t> v) {
@@ -175,6 +187,14 @@ TEST_SUBMODULE(stl, m) {
         return std::visit(visitor(), v);
     });
 
+    // The no-conversion pass only tries the alternatives that can accept the argument's type
+    m.def("load_variant_dispatch", [](std::variant<bool, UserType, int, double, std::string> v) {
+        return std::visit(visitor(), v);
+    });
+    m.def("load_variant_convert", [](std::variant<UserType, double> v) {
+        return std::visit(visitor(), v);
+    });
+
     m.def("cast_variant", []() {
         using V = std::variant<int, std::string>;
         return py::make_tuple(V(5), V("Hello"));
@@ -202,4 +222,18 @@ TEST_SUBMODULE(stl, m) {
 
     // test_stl_pass_by_pointer
     m.def("stl_pass_by_pointer", [](std::vector<int>* v) { return *v; }, "v"_a=nullptr);
+
+    // test_lazy_sequence
+    m.def("lazy_range", [](int n) {
+        std::vector<int> v((size_t) n);
+        for (int i = 0; i < n; i++)
+            v[(size_t) i] = i;
+        return py::make_lazy_sequence(std::move(v));
+    });
+    m.def("lazy_user_types", []() {
+        return py::make_lazy_sequence(std::vector<UserType>{UserType(1), UserType(2), UserType(3)});
+    });
+    m.def("lazy_strings", []() {
+        return py::lazy_sequence<std::list<std::string>>({"a", "b", "c", "d"});
+    });
 }
@@ -1,7 +1,7 @@
 import pytest
 
 from pybind11_tests import stl as m
-from pybind11_tests import UserType
+from pybind11_tests import UserType, IncType
 
 
 def test_vector(doc):
@@ -43,6 +43,13 @@ def test_map(doc):
     d["key2"] = "value2"
     assert m.load_map(d)
 
+    assert m.load_unordered_map({"a": 1, "b": 2, "c": 3})
+
+    rows = m.cast_map_rows(3)
+    assert rows == [{"id": i, "value": 10 * i} for i in range(3)]
+    keys = [sorted(row.keys()) for row in rows]
+    assert all(k[0] is keys[0][0] and k[1] is keys[0][1] for k in keys)
+
     assert doc(m.cast_map) == "cast_map() -> Dict[str, str]"
     assert doc(m.load_map) == "load_map(arg0: Dict[str, str]) -> bool"
 
@@ -141,6 +148,35 @@ def test_variant(doc):
     assert m.load_variant_2pass(1) == "int"
     assert m.load_variant_2pass(1.0) == "double"
 
+    class Index(object):
+        def __index__(self):
+            return 3
+
+        __int__ = __index__
+
+    class Float(float):
+        pass
+
+    class Derived(UserType):
+        pass
+
+    for _ in range(2):  # the second round uses the cached dispatch entries
+        assert m.load_variant_dispatch(True) == "bool"
+        assert m.load_variant_dispatch(1) == "int"
+        assert m.load_variant_dispatch(Index()) == "int"
+        assert m.load_variant_dispatch(1.5) == "double"
+        assert m.load_variant_dispatch(Float(1.5)) == "double"
+        assert m.load_variant_dispatch("1") == "std::string"
+        assert m.load_variant_dispatch(UserType(3)) == "UserType"
+        assert m.load_variant_dispatch(Derived(3)) == "UserType"
+        assert m.load_variant_dispatch(IncType(3)) == "UserType"
+        with pytest.raises(TypeError):
+            m.load_variant_dispatch(None)
+
+        assert m.load_variant_convert(UserType()) == "UserType"
+        assert m.load_variant_convert(1.5) == "double"
+        assert m.load_variant_convert(2) == "double"
+
     assert m.cast_variant() == (5, "Hello")
 
     assert doc(m.load_variant) == "load_variant(arg0: Union[int, str, float, None]) -> str"
@@ -173,3 +209,41 @@ def test_stl_pass_by_pointer(msg):
     """  # noqa: E501 line too long
 
     assert m.stl_pass_by_pointer([1, 2, 3]) == [1, 2, 3]
+
+
+def test_lazy_sequence(doc):
+    r = m.lazy_range(1000000)
+    assert len(r) == 1000000
+    assert r[0] == 0 and r[123456] == 123456 and r[-1] == 999999
+    with pytest.raises(IndexError):
+        r[1000000]
+    with pytest.raises(IndexError):
+        r[-1000001]
+    assert r[10:15] == [10, 11, 12, 13, 14]
+    assert r[-3:] == [999997, 999998, 999999]
+    assert r[5:0:-2] == [5, 3, 1]
+    assert r[10:0] == []
+    assert r[-10**9::-1] == [] and m.lazy_range(0)[::-1] == []
+    it = iter(r)
+    assert [next(it) for _ in range(3)] == [0, 1, 2]
+
+    view = memoryview(r)
+    assert view.readonly and view.format == "i" and len(view) == 1000000
+    assert view[999] == 999
+    del view
+
+    u = m.lazy_user_types()
+    assert [x.value for x in u] == [1, 2, 3]
+    first = u[0]
+    assert [x.value for x in u[::2]] == [1, 3]
+    del u
+    assert first.value == 1  # the sequence is kept alive by its elements
+
+    s = m.lazy_strings()
+    assert len(s) == 4 and s[1] == "b" and s[-1] == "d"
+    assert list(s) == ["a", "b", "c", "d"]
+    assert s[::-1] == ["d", "c", "b", "a"]
+    with pytest.raises(TypeError):
+        memoryview(s)
+
+    assert doc(m.lazy_range) == "lazy_range(arg0: int) -> Sequence[int]"
@@ -75,6 +75,7 @@ test_initializer stl_binder_vector([](py::module &m) {
     py::bind_vector<std::vector<unsigned char>>(m, "VectorUChar", py::buffer_protocol());
     py::bind_vector<std::vector<unsigned int>>(m, "VectorInt", py::buffer_protocol());
     py::bind_vector<std::vector<bool>>(m, "VectorBool");
+    py::bind_vector<std::vector<double>>(m, "VectorDouble");
 
     py::bind_vector<std::vector<El>>(m, "VectorEl");
 
@@ -102,6 +103,8 @@ test_initializer stl_binder_map([](py::module &m) {
     py::bind_map<std::map<std::string, double const>>(m, "MapStringDoubleConst");
     py::bind_map<std::unordered_map<std::string, double const>>(m, "UnorderedMapStringDoubleConst");
 
+    py::bind_map<std::map<int, double>>(m, "MapIntDouble");
+
 });
 
 test_initializer stl_binder_noncopyable([](py::module &m) {
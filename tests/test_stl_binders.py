@@ -89,6 +89,69 @@ def test_vector_buffer_numpy():
     assert len(v) == 3
 
 
+def test_vector_bulk():
+    from array import array
+    from pybind11_tests import VectorInt, VectorDouble, VectorBool, VectorEl, El
+
+    v = VectorInt([1])
+    v.extend([2, 3])
+    v.extend(x for x in range(4, 6))
+    v.extend(array('b', [6, 7]))
+    v.extend(array('Q', [8]))
+    v.extend(memoryview(array('h', range(9, 20)))[::5])
+    assert list(v) == [1, 2, 3, 4, 5, 6, 7, 8, 9, 14, 19]
+
+    v.assign(array('B', [3, 2, 1]))
+    assert list(v) == [3, 2, 1]
+    v.assign(range(2))
+    assert list(v) == [0, 1]
+
+    # Floats can't be converted to integers, and values must be in range
+    with pytest.raises(TypeError):
+        v.extend(array('d', [1.0]))
+    with pytest.raises(ValueError):
+        v.extend(array('b', [1, -1]))
+    with pytest.raises(ValueError):
+        v.assign(array('q', [2**32]))
+    with pytest.raises(TypeError) as excinfo:
+        v.extend([2, "three"])
+    assert "item 1 of type 'str'" in str(excinfo.value)
+    with pytest.raises(TypeError):
+        v.assign([2, "three"])
+    assert list(v) == [0, 1]
+
+    f = VectorDouble.from_numpy(array('d', [0.5, 1.5]))
+    f.extend(array('i', [-2]))
+    f.extend([2.5])
+    assert list(f) == [0.5, 1.5, -2, 2.5]
+
+    b = VectorBool.from_numpy(memoryview(b'\x00\x01').cast('?'))
+    assert list(b) == [False, True]
+    with pytest.raises(TypeError):
+        b.extend(array('b', [1]))
+
+    e = VectorEl()
+    e.assign([El(1), El(2)])
+    e.extend((El(3),))
+    assert str(e) == "VectorEl[El{1}, El{2}, El{3}]"
+
+
+@pytest.unsupported_on_pypy
+@pytest.requires_numpy
+def test_vector_bulk_numpy():
+    from pybind11_tests import VectorInt, VectorDouble
+
+    f = VectorDouble.from_numpy(np.linspace(0, 1, 5))
+    assert list(f) == [0, 0.25, 0.5, 0.75, 1]
+    a = f.to_numpy()
+    assert a.dtype == np.float64 and a.tolist() == [0, 0.25, 0.5, 0.75, 1]
+
+    v = VectorInt()
+    v.extend(np.arange(10, dtype=np.int64)[::3])
+    assert list(v) == [0, 3, 6, 9]
+    assert v.to_numpy().dtype == np.uintc
+
+
 def test_vector_custom():
     from pybind11_tests import El, VectorEl, VectorVectorEl
 
@@ -134,6 +197,51 @@ def test_map_string_double():
     assert "UnorderedMapStringDouble" in str(um)
 
 
+def test_map_bulk():
+    from pybind11_tests import (MapStringDouble, UnorderedMapStringDouble, MapStringDoubleConst,
+                                MapIntDouble)
+
+    for cls in [MapStringDouble, UnorderedMapStringDouble, MapStringDoubleConst]:
+        m = cls({'a': 1, 'b': 2.5})
+        assert sorted(m.keys()) == ['a', 'b']
+        assert sorted(m.values()) == [1, 2.5]
+        assert sorted(m.items()) == [('a', 1), ('b', 2.5)]
+        assert sorted(m.items_list()) == [('a', 1), ('b', 2.5)]
+        assert not isinstance(m.items(), list)
+
+        m.update({'b': 3, 'c': 4})
+        m.update([('d', 5), ('a', 0)])
+        m.update(cls({'e': 6}))
+        m.update(m)
+        assert sorted(m.items()) == [('a', 0), ('b', 3), ('c', 4), ('d', 5), ('e', 6)]
+
+        assert m.get('c') == 4
+        assert m.get('z') is None
+        assert m.get('z', -1) == -1
+
+        # A failed update leaves the map unchanged
+        with pytest.raises(ValueError):
+            m.update([('f', 1), ('g', 1, 2)])
+        with pytest.raises(RuntimeError):
+            m.update([('f', 1), ('g', 'not a number')])
+        with pytest.raises(RuntimeError):
+            m.update({'a': 7, 'f': 'not a number'})
+        assert sorted(m.items()) == [('a', 0), ('b', 3), ('c', 4), ('d', 5), ('e', 6)]
+
+    um = UnorderedMapStringDouble()
+    um.reserve(100)
+    assert not hasattr(MapStringDouble, 'reserve')
+
+    m = MapStringDouble({'a': 1, 'b': 2.5})
+    assert m.values_buffer().format == 'd'
+    assert m.values_buffer().tolist() == [1, 2.5]
+    assert not hasattr(m, 'keys_buffer')
+
+    mi = MapIntDouble({3: 0.5, 1: 1.5})
+    assert mi.keys_buffer().tolist() == [1, 3]
+    assert mi.values_buffer().tolist() == [1.5, 0.5]
+
+
 def test_map_string_double_const():
     from pybind11_tests import MapStringDoubleConst, UnorderedMapStringDoubleConst
 